@@ -0,0 +1,557 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "latency_histogram.h"
+#include "perf_counters.h"
+#include "workload.h"
+
+using namespace std;
+
+// One benchmark loop for every backend. A backend is any class with
+//   static constexpr const char* kName;         // "Vector", "AVL Tree", ...
+//   static constexpr const char* kDescription;  // what the variant does, for the banner
+//   bool load(const string& dataset);
+//   size_t size() const;
+//   size_t emailCount() const;                  // emails/groups the ops pick from, by index,
+//   size_t groupCount() const;                  // listed in sortKeys order
+//   void mostStudents();                        // Op1
+//   void changeGroup(size_t email, size_t group);  // Op2
+//   void highestRating();                       // Op3
+//   string mostStudentsGroup();                 // answers, for the verification lines
+//   string highestRatingGroup();
+// and optionally
+//   bool lookup(size_t email);                  // email lookup alone, timed separately
+
+struct BenchmarkConfig {
+    string dataset = "students.csv";
+    WorkloadSpec workload;
+    double seconds = 10.0;
+    double warmupSeconds = 1.0;
+    uint64_t seed = 42;             // 0 = seed from random_device
+    size_t ops = 0;                 // run exactly this many ops instead of `seconds`
+    string recordFile;              // write those ops as a trace
+    string replayFile;              // run the ops of a trace instead
+    size_t lookups = 1000000;
+    double perfSeconds = 0.5;       // counter pass per op type, 0 = only the whole mix
+    string jsonFile;                // also write the result here
+};
+
+struct BenchmarkResult {
+    string backend;
+    string dataset;
+    size_t records = 0;
+    double loadSeconds = 0.0;
+    uint64_t seed = 0;
+    WorkloadSpec workload;          // from the trace when replaying
+    string trace;
+    double seconds = 0.0;
+    uint64_t opCounts[3] = {0, 0, 0};
+    uint64_t totalOps = 0;
+    LatencyHistogram latency[3];     // per op type, in CycleClock ticks
+    double lookupsPerSecond = -1.0;  // negative when the backend has no lookup()
+    string perfError;                // why (some) counters are missing
+    PerfSample perfMix;              // over the timed op mix
+    PerfSample perfOps[3];           // over each op type run alone
+    uint64_t perfOpCounts[3] = {0, 0, 0};
+    string mostStudentsGroup;
+    string highestRatingGroup;
+
+    double opsPerSecond() const {
+        return seconds > 0 ? totalOps / seconds : 0.0;
+    }
+};
+
+// Usage: [--dataset students.csv] [--mix 5:1:100] [--email-skew 0] [--group-skew 0]
+//        [--seconds 10 | --ops N [--record trace.bin] | --replay trace.bin] [--warmup 1]
+//        [--seed 42] [--lookups 1000000] [--perf-seconds 0.5] [--json result.json]
+BenchmarkConfig parseBenchmarkArgs(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        string value = argv[i + 1];
+        if (arg == "--dataset") {
+            config.dataset = value;
+        } else if (arg == "--mix") {
+            parseMix(value, config.workload);
+        } else if (arg == "--email-skew") {
+            config.workload.emailSkew = parseSkew(value);
+        } else if (arg == "--group-skew") {
+            config.workload.groupSkew = parseSkew(value);
+        } else if (arg == "--seconds") {
+            config.seconds = stod(value);
+        } else if (arg == "--warmup") {
+            config.warmupSeconds = stod(value);
+        } else if (arg == "--seed") {
+            config.seed = stoull(value);
+        } else if (arg == "--ops") {
+            config.ops = stoull(value);
+        } else if (arg == "--record") {
+            config.recordFile = value;
+        } else if (arg == "--replay") {
+            config.replayFile = value;
+        } else if (arg == "--lookups") {
+            config.lookups = stoull(value);
+        } else if (arg == "--perf-seconds") {
+            config.perfSeconds = stod(value);
+        } else if (arg == "--json") {
+            config.jsonFile = value;
+        } else {
+            cerr << "Unknown option " << arg << endl;
+        }
+    }
+    return config;
+}
+
+// Backends list the emails and groups they pick from sorted and without duplicates, so
+// an index names the same email or group in every backend and a trace replays the same
+// changes everywhere
+template <class T, class Less = less<T>>
+void sortKeys(vector<T>& keys, Less less = Less()) {
+    sort(keys.begin(), keys.end(), less);
+    keys.erase(unique(keys.begin(), keys.end(), [&](const T& a, const T& b) { return !less(a, b) && !less(b, a); }),
+               keys.end());
+}
+
+template <class Backend, class = void>
+struct HasLookup : false_type {};
+
+template <class Backend>
+struct HasLookup<Backend, void_t<decltype(declval<Backend&>().lookup(size_t()))>> : true_type {};
+
+// Runs ops from nextOp(op) until it returns false or endTick has passed, adding the ops
+// of each type to counts and the time of each op to latency. Only the op itself is timed,
+// not picking it; the timestamp that ends one op also serves for the deadline check.
+template <class Backend, class NextOp>
+void runOps(Backend& backend, NextOp&& nextOp, uint64_t endTick, uint64_t (&counts)[3],
+            LatencyHistogram (&latency)[3]) {
+    WorkloadOp op;
+    uint64_t now = 0;
+    while (now < endTick && nextOp(op)) {
+        uint64_t start = CycleClock::now();
+        if (op.type == kOpMostStudents) {
+            backend.mostStudents();
+        } else if (op.type == kOpChangeGroup) {
+            backend.changeGroup(op.email, op.group);
+        } else {
+            backend.highestRating();
+        }
+        now = CycleClock::now();
+        counts[op.type]++;
+        latency[op.type].record(now - start);
+    }
+}
+
+uint64_t deadlineAfter(double seconds) {
+    return CycleClock::now() + uint64_t(seconds * CycleClock::ticksPerSecond());
+}
+
+// Loads the dataset, warms up, runs the op mix, then times lookups if supported.
+// The op mix runs for config.seconds, or exactly config.ops generated ops, or the ops of
+// a trace. With a fixed op list the warmup leaves out Op2, so every run starts from
+// the loaded data and ends in the same state.
+template <class Backend>
+bool runBenchmark(Backend& backend, const BenchmarkConfig& config, BenchmarkResult& result) {
+    result.backend = Backend::kName;
+    result.dataset = config.dataset;
+
+    auto loadStart = chrono::steady_clock::now();
+    if (!backend.load(config.dataset) || backend.emailCount() == 0 || backend.groupCount() == 0) {
+        cerr << "No data loaded!" << endl;
+        return false;
+    }
+    result.loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - loadStart).count();
+    result.records = backend.size();
+
+    size_t emailCount = backend.emailCount();
+    size_t groupCount = backend.groupCount();
+    result.seed = config.seed != 0 ? config.seed : random_device()();
+    result.workload = config.workload;
+
+    vector<WorkloadOp> ops;
+    bool fixedOps = !config.replayFile.empty() || config.ops > 0;
+    if (!config.replayFile.empty()) {
+        TraceHeader header;
+        if (!readTrace(config.replayFile, header, ops)) {
+            return false;
+        }
+        if (header.emailCount != emailCount || header.groupCount != groupCount) {
+            cerr << "Trace " << config.replayFile << " was recorded with " << header.emailCount << " emails and "
+                 << header.groupCount << " groups, " << config.dataset << " has " << emailCount << " and "
+                 << groupCount << endl;
+            return false;
+        }
+        result.trace = config.replayFile;
+        result.seed = header.seed;
+        copy(header.mix, header.mix + 3, result.workload.mix);
+        result.workload.emailSkew = header.emailSkew;
+        result.workload.groupSkew = header.groupSkew;
+    } else if (config.ops > 0) {
+        ops = WorkloadGenerator(config.workload, emailCount, groupCount, result.seed).generate(config.ops);
+        if (!config.recordFile.empty() &&
+            !writeTrace(config.recordFile, config.workload, result.seed, emailCount, groupCount, ops)) {
+            return false;
+        }
+    } else if (!config.recordFile.empty()) {
+        cerr << "--record needs --ops" << endl;
+        return false;
+    }
+
+    WorkloadSpec warmupSpec = result.workload;
+    if (fixedOps) {
+        warmupSpec.mix[1] = 0;
+    }
+    WorkloadGenerator generator(warmupSpec, emailCount, groupCount, result.seed);
+    auto generated = [&](WorkloadOp& op) {
+        op = generator.next();
+        return true;
+    };
+
+    uint64_t warmupCounts[3] = {0, 0, 0};
+    LatencyHistogram warmupLatency[3];
+    if (config.warmupSeconds > 0 && warmupSpec.mix[0] + warmupSpec.mix[1] + warmupSpec.mix[2] > 0) {
+        runOps(backend, generated, deadlineAfter(config.warmupSeconds), warmupCounts, warmupLatency);
+    }
+
+    PerfCounters counters;
+    result.perfError = counters.error();
+    counters.start();
+    auto start = chrono::steady_clock::now();
+    if (fixedOps) {
+        size_t next = 0;
+        runOps(backend, [&](WorkloadOp& op) {
+            if (next == ops.size()) return false;
+            op = ops[next++];
+            return true;
+        }, UINT64_MAX, result.opCounts, result.latency);
+    } else {
+        runOps(backend, generated, deadlineAfter(config.seconds), result.opCounts, result.latency);
+    }
+    result.perfMix = counters.stop();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.totalOps = result.opCounts[0] + result.opCounts[1] + result.opCounts[2];
+
+    result.mostStudentsGroup = backend.mostStudentsGroup();
+    result.highestRatingGroup = backend.highestRatingGroup();
+
+    if constexpr (HasLookup<Backend>::value) {
+        mt19937_64 lookupGen(result.seed);
+        KeyChooser emailKeys(emailCount, result.workload.emailSkew);
+        vector<uint32_t> lookupEmails(config.lookups);
+        for (auto& email : lookupEmails) {
+            email = uint32_t(emailKeys(lookupGen));
+        }
+        size_t found = 0;
+        auto lookupStart = chrono::steady_clock::now();
+        for (uint32_t email : lookupEmails) {
+            found += backend.lookup(email);
+        }
+        double lookupSeconds = chrono::duration<double>(chrono::steady_clock::now() - lookupStart).count();
+        result.lookupsPerSecond = lookupSeconds > 0 ? config.lookups / lookupSeconds : 0.0;
+        if (found != config.lookups) {
+            cerr << "Lookups found " << found << " of " << config.lookups << " emails" << endl;
+        }
+    }
+    return true;
+}
+
+// Counters cannot be read per op (a read is a syscall, slower than Op1), so each op
+// type runs alone for perfSeconds and the counts are divided by its ops. benchmarkMain
+// calls this after the answers, lookups and program extras are done, so the Op2 pass
+// runs last and may change `backend`; nothing reads it afterwards.
+template <class Backend>
+void runPerfPasses(Backend& backend, const BenchmarkConfig& config, BenchmarkResult& result) {
+    PerfCounters counters;
+    if (!counters.available() || config.perfSeconds <= 0) {
+        return;
+    }
+
+    const uint32_t order[3] = {kOpMostStudents, kOpHighestRating, kOpChangeGroup};
+    for (uint32_t type : order) {
+        WorkloadSpec single = result.workload;
+        for (uint32_t other = 0; other < 3; other++) {
+            single.mix[other] = other == type ? 1 : 0;
+        }
+        WorkloadGenerator generator(single, backend.emailCount(), backend.groupCount(), result.seed + type + 1);
+        LatencyHistogram latency[3];
+        counters.start();
+        runOps(backend, [&](WorkloadOp& op) {
+            op = generator.next();
+            return true;
+        }, deadlineAfter(config.perfSeconds), result.perfOpCounts, latency);
+        result.perfOps[type] = counters.stop();
+    }
+}
+
+// Builds one flat JSON object; strings are escaped
+class JsonObject {
+private:
+    string body;
+
+    void key(const string& name) {
+        if (!body.empty()) body += ", ";
+        body += quote(name) + ": ";
+    }
+
+public:
+    static string quote(const string& text) {
+        string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    JsonObject& add(const string& name, const string& value) {
+        key(name);
+        body += quote(value);
+        return *this;
+    }
+
+    JsonObject& add(const string& name, double value) {
+        key(name);
+        ostringstream number;
+        number << setprecision(17) << value;
+        body += number.str();
+        return *this;
+    }
+
+    JsonObject& add(const string& name, uint64_t value) {
+        key(name);
+        body += to_string(value);
+        return *this;
+    }
+
+    JsonObject& add(const string& name, const JsonObject& value) {
+        key(name);
+        body += value.str();
+        return *this;
+    }
+
+    // Anything already formatted as JSON (arrays)
+    JsonObject& addRaw(const string& name, const string& json) {
+        key(name);
+        body += json;
+        return *this;
+    }
+
+    string str() const {
+        return "{" + body + "}";
+    }
+};
+
+const char* const kOpNames[3] = {"op1", "op2", "op3"};
+
+// count, p50, p99, p999, max and mean of one op type, in nanoseconds
+JsonObject latencyJson(const LatencyHistogram& histogram) {
+    double nsPerTick = 1e9 / CycleClock::ticksPerSecond();
+    JsonObject json;
+    json.add("count", histogram.count())
+        .add("p50", histogram.percentile(0.5) * nsPerTick)
+        .add("p99", histogram.percentile(0.99) * nsPerTick)
+        .add("p999", histogram.percentile(0.999) * nsPerTick)
+        .add("max", histogram.max() * nsPerTick)
+        .add("mean", histogram.mean() * nsPerTick);
+    return json;
+}
+
+// Counter values per op; counters that are missing are left out
+JsonObject perfJson(const PerfSample& sample, uint64_t ops) {
+    JsonObject json;
+    json.add("ops", ops);
+    for (int i = 0; i < kPerfCounterCount; i++) {
+        if (sample.has[i]) {
+            json.add(kPerfCounterNames[i], ops > 0 ? double(sample.value[i]) / ops : 0.0);
+        }
+    }
+    return json;
+}
+
+// Same key names as the report of run_all_measurements.py
+JsonObject benchmarkJson(const BenchmarkResult& result, const BenchmarkConfig& config) {
+    JsonObject json;
+    json.add("backend", result.backend)
+        .add("dataset", result.dataset)
+        .add("records", uint64_t(result.records))
+        .add("load_seconds", result.loadSeconds)
+        .add("seed", result.seed)
+        .addRaw("mix", "[" + to_string(result.workload.mix[0]) + ", " + to_string(result.workload.mix[1]) + ", " +
+                           to_string(result.workload.mix[2]) + "]")
+        .add("email_skew", result.workload.emailSkew)
+        .add("group_skew", result.workload.groupSkew)
+        .add("warmup_seconds", config.warmupSeconds)
+        .add("duration_ms", uint64_t(result.seconds * 1000.0))
+        .add("total_operations", result.totalOps)
+        .add("ops_per_second", result.opsPerSecond())
+        .add("op1_count", result.opCounts[0])
+        .add("op2_count", result.opCounts[1])
+        .add("op3_count", result.opCounts[2])
+        .add("most_students_group", result.mostStudentsGroup)
+        .add("highest_rating_group", result.highestRatingGroup);
+    if (!result.trace.empty()) {
+        json.add("trace", result.trace);
+    }
+    JsonObject latency;
+    for (int op = 0; op < 3; op++) {
+        latency.add(kOpNames[op], latencyJson(result.latency[op]));
+    }
+    json.add("latency_ns", latency);
+    if (!result.perfError.empty()) {
+        json.add("perf_error", result.perfError);
+    }
+    JsonObject perf;
+    perf.add("mix", perfJson(result.perfMix, result.totalOps));
+    for (int op = 0; op < 3; op++) {
+        if (result.perfOpCounts[op] > 0) {
+            perf.add(kOpNames[op], perfJson(result.perfOps[op], result.perfOpCounts[op]));
+        }
+    }
+    json.add("perf_counters", perf);
+    if (result.lookupsPerSecond >= 0) {
+        json.add("lookups_per_second", result.lookupsPerSecond);
+    }
+    return json;
+}
+
+void printBenchmarkResult(const BenchmarkResult& result, const BenchmarkConfig& config,
+                          const string& description) {
+    cout << "Loaded " << result.records << " students in " << fixed << setprecision(1)
+         << result.loadSeconds * 1000.0 << " ms" << endl << endl;
+    cout << "Benchmark " << description << " (";
+    if (!result.trace.empty()) {
+        cout << result.totalOps << " ops from " << result.trace;
+    } else if (config.ops > 0) {
+        cout << config.ops << " ops";
+    } else {
+        cout << setprecision(0) << config.seconds << " seconds";
+    }
+    cout << ", " << setprecision(0) << config.warmupSeconds << " s warmup, seed " << result.seed << ")" << endl;
+    cout << "Operation ratio - Op1:Op2:Op3 = " << result.workload.mix[0] << ":" << result.workload.mix[1] << ":"
+         << result.workload.mix[2] << endl;
+    cout << "Zipf skew - emails: " << setprecision(2) << result.workload.emailSkew
+         << ", groups: " << result.workload.groupSkew << endl << endl;
+
+    cout << "=== BENCHMARK RESULTS (" << result.backend << ") ===" << endl;
+    cout << "Duration: " << uint64_t(result.seconds * 1000.0) << " ms" << endl;
+    cout << "Total operations: " << result.totalOps << endl;
+    cout << "Operations per second: " << setprecision(1) << result.opsPerSecond() << endl << endl;
+
+    cout << "Operation 1 (Find group with most students): " << result.opCounts[0] << endl;
+    cout << "Operation 2 (Change student group): " << result.opCounts[1] << endl;
+    cout << "Operation 3 (Find group with highest rating): " << result.opCounts[2] << endl << endl;
+
+    cout << "Actual ratio: " << result.opCounts[0] << ":" << result.opCounts[1] << ":"
+         << result.opCounts[2] << endl;
+    double ratio1 = result.opCounts[1] > 0 ? double(result.opCounts[0]) / result.opCounts[1] : 0;
+    double ratio3 = result.opCounts[1] > 0 ? double(result.opCounts[2]) / result.opCounts[1] : 0;
+    cout << "Normalized ratio: " << ratio1 << ":1:" << ratio3 << endl;
+
+    cout << "\n=== LATENCY (ns) ===" << endl;
+    double nsPerTick = 1e9 / CycleClock::ticksPerSecond();
+    cout << left << setw(6) << "Op" << right << setw(12) << "count" << setw(10) << "p50" << setw(10) << "p99"
+         << setw(10) << "p999" << setw(12) << "max" << setw(10) << "mean" << endl;
+    for (int op = 0; op < 3; op++) {
+        const LatencyHistogram& h = result.latency[op];
+        cout << left << setw(6) << "Op" + to_string(op + 1) << right << setprecision(0) << setw(12) << h.count()
+             << setw(10) << h.percentile(0.5) * nsPerTick << setw(10) << h.percentile(0.99) * nsPerTick
+             << setw(10) << h.percentile(0.999) * nsPerTick << setw(12) << h.max() * nsPerTick << setw(10)
+             << h.mean() * nsPerTick << endl;
+    }
+
+    cout << "\n=== VERIFICATION ===" << endl;
+    cout << "Group with most students: " << result.mostStudentsGroup << endl;
+    cout << "Group with highest rating: " << result.highestRatingGroup << endl;
+    if (result.lookupsPerSecond >= 0) {
+        cout << "Email lookups per second: " << setprecision(0) << result.lookupsPerSecond << endl;
+    }
+}
+
+void printPerfCounters(const BenchmarkResult& result) {
+    cout << "\n=== PERF COUNTERS (per op) ===" << endl;
+    if (!result.perfError.empty()) {
+        cout << result.perfError << endl;
+    }
+    cout << left << setw(6) << "Op";
+    for (const char* name : kPerfCounterNames) {
+        cout << right << setw(15) << name;
+    }
+    cout << endl;
+    auto printPerf = [](const string& label, const PerfSample& sample, uint64_t ops) {
+        cout << left << setw(6) << label << right << setprecision(2);
+        for (int i = 0; i < kPerfCounterCount; i++) {
+            if (sample.has[i] && ops > 0) {
+                cout << setw(15) << double(sample.value[i]) / ops;
+            } else {
+                cout << setw(15) << "-";
+            }
+        }
+        cout << endl;
+    };
+    printPerf("Mix", result.perfMix, result.totalOps);
+    for (int op = 0; op < 3; op++) {
+        if (result.perfOpCounts[op] > 0) {
+            printPerf("Op" + to_string(op + 1), result.perfOps[op], result.perfOpCounts[op]);
+        }
+    }
+}
+
+bool writeBenchmarkJson(const BenchmarkResult& result, const BenchmarkConfig& config) {
+    ofstream file(config.jsonFile);
+    if (!file.is_open()) {
+        cerr << "Error creating file " << config.jsonFile << endl;
+        return false;
+    }
+    file << benchmarkJson(result, config).str() << endl;
+    return true;
+}
+
+// Whole measure program: parse the options, run, print, and write JSON if asked.
+// afterRun(backend) runs right after the results are printed, on the state the op mix
+// left and before the counter passes. Returns the exit code.
+template <class Backend, class AfterRun>
+int benchmarkMain(Backend& backend, int argc, char* argv[], AfterRun&& afterRun) {
+    BenchmarkConfig config = parseBenchmarkArgs(argc, argv);
+    BenchmarkResult result;
+
+    cout << "Loading students from " << config.dataset << "..." << endl;
+    if (!runBenchmark(backend, config, result)) {
+        return 1;
+    }
+    printBenchmarkResult(result, config, Backend::kDescription);
+    afterRun(backend);
+
+    runPerfPasses(backend, config, result);
+    printPerfCounters(result);
+    if (!config.jsonFile.empty() && !writeBenchmarkJson(result, config)) {
+        return 1;
+    }
+    return 0;
+}
+
+template <class Backend>
+int benchmarkMain(Backend& backend, int argc, char* argv[]) {
+    return benchmarkMain(backend, argc, argv, [](Backend&) {});
+}
+
+#endif // BENCHMARK_H
@@ -0,0 +1,134 @@
+#ifndef BIRTHDAY_SORT_H
+#define BIRTHDAY_SORT_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "mapped_csv.h"
+
+using namespace std;
+
+// (month, day) packed into one 9-bit radix digit, so a single counting pass sorts by
+// birthday: kBirthdayKeys buckets cover months 0..12 and days 0..31
+constexpr size_t kBirthdayKeys = 13 * 32;
+
+// Out-of-range months and days are clamped into the table (month 13 sorts as 12,
+// day 99 as 31), so a bad row only sorts approximately instead of indexing past the
+// histogram. The external sort and the introsort use the same key.
+inline uint16_t birthdayKey(int month, int day) {
+    month = month < 0 ? 0 : (month > 12 ? 12 : month);
+    day = day < 0 ? 0 : (day > 31 ? 31 : day);
+    return static_cast<uint16_t>(month * 32 + day);
+}
+
+template <class StudentT>
+uint16_t birthdayKey(const StudentT& student) {
+    return birthdayKey(student.m_birth_month, student.m_birth_day);
+}
+
+// Turns keys[i] into the stable position of record i: histogram, exclusive prefix
+// sum, then one scan handing out slots. keys is 2 bytes per record, so both passes
+// stream through cache instead of touching the records.
+void birthdayPositions(const vector<uint16_t>& keys, vector<uint32_t>& positions) {
+    uint32_t starts[kBirthdayKeys] = {};
+    for (uint16_t key : keys) {
+        starts[key]++;
+    }
+    uint32_t offset = 0;
+    for (size_t key = 0; key < kBirthdayKeys; key++) {
+        uint32_t count = starts[key];
+        starts[key] = offset;
+        offset += count;
+    }
+
+    positions.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        positions[i] = starts[keys[i]]++;
+    }
+}
+
+// Stable sort by (month, day). Records are moved exactly once, into their final slot.
+template <class StudentT>
+void sortByBirthday(vector<StudentT>& students) {
+    if (students.size() < 2) return;
+
+    vector<uint16_t> keys(students.size());
+    for (size_t i = 0; i < students.size(); i++) {
+        keys[i] = birthdayKey(students[i]);
+    }
+    vector<uint32_t> positions;
+    birthdayPositions(keys, positions);
+
+    vector<StudentT> sorted(students.size());
+    for (size_t i = 0; i < students.size(); i++) {
+        sorted[positions[i]] = move(students[i]);
+    }
+    students.swap(sorted);
+}
+
+// Stable birthday order of any range of records (e.g. a tree walked in email order),
+// as pointers: one pass over the range, no record is copied or moved
+template <class StudentT, class Range>
+vector<const StudentT*> sortedByBirthday(const Range& range, size_t count) {
+    vector<const StudentT*> records;
+    vector<uint16_t> keys;
+    records.reserve(count);
+    keys.reserve(count);
+    for (const StudentT& student : range) {
+        records.push_back(&student);
+        keys.push_back(birthdayKey(student));
+    }
+    vector<uint32_t> positions;
+    birthdayPositions(keys, positions);
+
+    vector<const StudentT*> sorted(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        sorted[positions[i]] = records[i];
+    }
+    return sorted;
+}
+
+// Multi-threaded sortByBirthday, same (stable) result. Each worker builds a histogram of
+// its slice; the prefix sum walks keys outer, workers inner, so worker t's records of a
+// key land after those of workers < t. Workers then scatter their slices independently.
+// threads = 0 uses all cores; small inputs fall back to the serial sort.
+template <class StudentT>
+void sortByBirthdayParallel(vector<StudentT>& students, unsigned threads = 0) {
+    size_t n = students.size();
+    if (threads == 0) threads = defaultThreadCount();
+    if (threads > n / 4096) threads = max<size_t>(1, n / 4096);
+    if (threads <= 1) {
+        sortByBirthday(students);
+        return;
+    }
+
+    vector<uint16_t> keys(n);
+    vector<vector<uint32_t>> starts(threads, vector<uint32_t>(kBirthdayKeys, 0));
+    forEachSlice(n, threads, [&](unsigned t, size_t begin, size_t end) {
+        uint32_t* histogram = starts[t].data();
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = birthdayKey(students[i]);
+            histogram[keys[i]]++;
+        }
+    });
+
+    uint32_t offset = 0;
+    for (size_t key = 0; key < kBirthdayKeys; key++) {
+        for (unsigned t = 0; t < threads; t++) {
+            uint32_t count = starts[t][key];
+            starts[t][key] = offset;
+            offset += count;
+        }
+    }
+
+    vector<StudentT> sorted(n);
+    forEachSlice(n, threads, [&](unsigned t, size_t begin, size_t end) {
+        uint32_t* next = starts[t].data();
+        for (size_t i = begin; i < end; i++) {
+            sorted[next[keys[i]]++] = move(students[i]);
+        }
+    });
+    students.swap(sorted);
+}
+
+#endif // BIRTHDAY_SORT_H
@@ -0,0 +1,242 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_csv.h"
+
+using namespace std;
+
+// Appends to a file through one fixed buffer
+class BufferedFileWriter {
+private:
+    int fd = -1;
+    vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+
+public:
+    BufferedFileWriter(const string& path, size_t bufferSize) : buffer(max<size_t>(bufferSize, 4096)) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    ~BufferedFileWriter() {
+        close();
+    }
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    void write(string_view data) {
+        if (used + data.size() > buffer.size()) {
+            flush();
+            if (data.size() > buffer.size()) {
+                writeAll(data.data(), data.size());
+                return;
+            }
+        }
+        memcpy(buffer.data() + used, data.data(), data.size());
+        used += data.size();
+    }
+
+    void writeLine(string_view line) {
+        write(line);
+        write("\n");
+    }
+
+    // Room for at least `size` bytes to format into directly; follow with commit()
+    char* reserve(size_t size) {
+        if (used + size > buffer.size()) {
+            flush();
+            if (size > buffer.size()) {
+                buffer.resize(size);
+            }
+        }
+        return buffer.data() + used;
+    }
+
+    void commit(const char* end) {
+        used = end - buffer.data();
+    }
+
+    void flush() {
+        writeAll(buffer.data(), used);
+        used = 0;
+    }
+
+    // False if any write failed
+    bool close() {
+        if (fd >= 0) {
+            flush();
+            ::close(fd);
+            fd = -1;
+        }
+        return !failed;
+    }
+
+private:
+    void writeAll(const char* data, size_t size) {
+        while (size > 0 && !failed) {
+            ssize_t written = ::write(fd, data, size);
+            if (written <= 0) {
+                failed = true;
+                return;
+            }
+            data += written;
+            size -= written;
+        }
+    }
+};
+
+constexpr string_view kStudentCSVHeader =
+    "m_name,m_surname,m_email,m_birth_year,m_birth_month,m_birth_day,m_group,m_rating,m_phone_number\n";
+
+// Longest text `%.2f` can produce for a double, plus the other numbers and separators
+constexpr size_t kStudentRowNumbers = 3 * 11 + 320 + 9;
+
+// Records can be passed by value or by pointer (e.g. radixSortByBirthday of a tree)
+template <class Item>
+const auto& recordOf(const Item& item) {
+    if constexpr (is_pointer<Item>::value) {
+        return *item;
+    } else {
+        return item;
+    }
+}
+
+template <class StudentT>
+size_t studentRowBound(const StudentT& s) {
+    return string_view(s.m_name).size() + string_view(s.m_surname).size() + string_view(s.m_email).size() +
+           string_view(s.m_group).size() + string_view(s.m_phone_number).size() + kStudentRowNumbers;
+}
+
+inline char* appendText(char* out, string_view text) {
+    memcpy(out, text.data(), text.size());
+    return out + text.size();
+}
+
+// Formats one row like `file << ... << fixed << setprecision(2) << rating`, but with
+// to_chars: no locale, no stream state, no virtual calls. `out` needs studentRowBound(s) bytes.
+template <class StudentT>
+char* formatStudentRow(char* out, const StudentT& s) {
+    out = appendText(out, s.m_name);
+    *out++ = ',';
+    out = appendText(out, s.m_surname);
+    *out++ = ',';
+    out = appendText(out, s.m_email);
+    *out++ = ',';
+    out = to_chars(out, out + 11, s.m_birth_year).ptr;
+    *out++ = ',';
+    out = to_chars(out, out + 11, s.m_birth_month).ptr;
+    *out++ = ',';
+    out = to_chars(out, out + 11, s.m_birth_day).ptr;
+    *out++ = ',';
+    out = appendText(out, s.m_group);
+    *out++ = ',';
+    out = to_chars(out, out + 320, s.m_rating, chars_format::fixed, 2).ptr;
+    *out++ = ',';
+    out = appendText(out, s.m_phone_number);
+    *out++ = '\n';
+    return out;
+}
+
+// Writes the header and `rows` rows into `filename` on `threads` workers, in rounds:
+// every worker formats the next block of its slice into its own buffer with
+// formatRows(buffer, begin, end), which returns the bytes used; the block sizes give
+// each one a file offset, and the workers pwrite their blocks side by side.
+// Returns false on I/O errors.
+template <class FormatRows>
+bool writeCSVParallel(const string& filename, size_t rows, unsigned threads, FormatRows&& formatRows) {
+    const size_t kBlockRows = 32768;
+
+    if (threads == 0) threads = defaultThreadCount();
+    if (threads > rows / kBlockRows) threads = max<size_t>(1, rows / kBlockRows);
+
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    off_t offset = pwrite(fd, kStudentCSVHeader.data(), kStudentCSVHeader.size(), 0);
+    bool ok = offset == off_t(kStudentCSVHeader.size());
+
+    vector<vector<char>> blocks(threads);
+    vector<size_t> blockSizes(threads);
+    vector<char> failed(threads, 0);
+    size_t rowsPerRound = kBlockRows * threads;
+    for (size_t first = 0; ok && first < rows; first += rowsPerRound) {
+        size_t roundRows = min(rowsPerRound, rows - first);
+
+        forEachSlice(roundRows, threads, [&](unsigned t, size_t begin, size_t end) {
+            blockSizes[t] = formatRows(blocks[t], first + begin, first + end);
+        });
+
+        vector<off_t> offsets(threads);
+        for (unsigned t = 0; t < threads; t++) {
+            offsets[t] = offset;
+            offset += blockSizes[t];
+        }
+
+        forEachSlice(threads, threads, [&](unsigned t, size_t, size_t) {
+            const char* data = blocks[t].data();
+            size_t size = blockSizes[t];
+            off_t at = offsets[t];
+            while (size > 0) {
+                ssize_t written = pwrite(fd, data, size, at);
+                if (written <= 0) {
+                    failed[t] = 1;
+                    return;
+                }
+                data += written;
+                size -= written;
+                at += written;
+            }
+        });
+        for (char f : failed) {
+            ok = ok && !f;
+        }
+    }
+
+    return ::close(fd) == 0 && ok;
+}
+
+// Writes the header and one row per record into `filename`: through a 4 MB buffer,
+// or with threads > 1 through writeCSVParallel. Returns false on I/O errors.
+template <class Item>
+bool writeStudentsCSV(const vector<Item>& records, const string& filename, unsigned threads = 1) {
+    const size_t kBufferSize = 4 << 20;
+
+    if (threads != 1) {
+        return writeCSVParallel(filename, records.size(), threads, [&](vector<char>& block, size_t begin, size_t end) {
+            size_t used = 0;
+            for (size_t i = begin; i < end; i++) {
+                const auto& s = recordOf(records[i]);
+                size_t bound = studentRowBound(s);
+                if (used + bound > block.size()) {
+                    block.resize(max(block.size() * 2, used + bound));
+                }
+                used = formatStudentRow(block.data() + used, s) - block.data();
+            }
+            return used;
+        });
+    }
+
+    BufferedFileWriter out(filename, kBufferSize);
+    if (!out.isOpen()) return false;
+    out.write(kStudentCSVHeader);
+    for (const auto& item : records) {
+        const auto& s = recordOf(item);
+        out.commit(formatStudentRow(out.reserve(studentRowBound(s)), s));
+    }
+    return out.close();
+}
+
+#endif // CSV_WRITER_H
@@ -0,0 +1,333 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_csv.h"
+#include "csv_writer.h"
+#include "birthday_sort.h"
+
+using namespace std;
+
+// Reads a file line by line through one fixed buffer (grown only for a line longer than it)
+class BufferedLineReader {
+private:
+    int fd = -1;
+    vector<char> buffer;
+    size_t begin = 0;
+    size_t end = 0;
+    bool atEnd = false;
+
+    bool refill() {
+        if (atEnd) return false;
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        ssize_t got = ::read(fd, buffer.data() + end, buffer.size() - end);
+        if (got <= 0) {
+            atEnd = true;
+            return false;
+        }
+        end += got;
+        return true;
+    }
+
+public:
+    BufferedLineReader(const string& path, size_t bufferSize) : buffer(max<size_t>(bufferSize, 4096)) {
+        fd = ::open(path.c_str(), O_RDONLY);
+    }
+
+    ~BufferedLineReader() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    BufferedLineReader(const BufferedLineReader&) = delete;
+    BufferedLineReader& operator=(const BufferedLineReader&) = delete;
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // The line (without '\n') stays valid until the next call
+    bool next(string_view& line) {
+        size_t scanned = begin;
+        while (true) {
+            const char* newline = static_cast<const char*>(
+                memchr(buffer.data() + scanned, '\n', end - scanned));
+            if (newline) {
+                line = string_view(buffer.data() + begin, newline - (buffer.data() + begin));
+                begin = newline - buffer.data() + 1;
+                return true;
+            }
+            scanned = end - begin;
+            if (!refill()) {
+                if (begin == end) return false;
+                line = string_view(buffer.data() + begin, end - begin);  // last line without '\n'
+                begin = end;
+                return true;
+            }
+        }
+    }
+};
+
+struct ExternalSortOptions {
+    size_t memoryBudget = 64 << 20;  // bytes for line data and I/O buffers together
+    string tempDir = ".";
+};
+
+struct ExternalSortStats {
+    size_t rows = 0;
+    size_t skippedRows = 0;  // lines parseStudentRow rejects; the CSV loaders skip them too
+    size_t bytes = 0;
+    size_t runs = 0;
+    size_t mergePasses = 0;
+    double seconds = 0.0;
+
+    double rowsPerSecond() const {
+        return seconds > 0 ? rows / seconds : 0.0;
+    }
+};
+
+// Birthday key of a CSV row, or false for a malformed row. An out-of-range month or day
+// is clamped by birthdayKey, as in sortByBirthday, so such rows are kept.
+bool rowBirthdayKey(string_view line, uint16_t& key) {
+    StudentRow row;
+    if (!parseStudentRow(line, row)) {
+        return false;
+    }
+    key = birthdayKey(row.birthMonth, row.birthDay);
+    return true;
+}
+
+// Line data of one run plus its refs, sorted stably by birthday and written in one go.
+// All storage is reserved up front from the budget and reused for every run, so the
+// memory footprint does not depend on the input size.
+class SortRun {
+private:
+    // offset, key, position, order
+    static constexpr size_t kBytesPerRef = sizeof(uint64_t) + sizeof(uint16_t) + 2 * sizeof(uint32_t);
+
+    string chars;
+    vector<uint64_t> offsets;  // 64-bit: a run may hold more than 4 GB of lines
+    vector<uint16_t> keys;
+
+public:
+    // 7/8 of the budget for line bytes, 1/8 for refs (lines are ~80 bytes, refs 18)
+    explicit SortRun(size_t budget) {
+        chars.reserve(budget / 8 * 7);
+        offsets.reserve(budget / 8 / kBytesPerRef);
+        keys.reserve(budget / 8 / kBytesPerRef);
+    }
+
+    bool fits(size_t lineSize) const {
+        return chars.size() + lineSize <= chars.capacity() && offsets.size() < offsets.capacity();
+    }
+
+    void add(string_view line, uint16_t key) {
+        offsets.push_back(chars.size());
+        keys.push_back(key);
+        chars.append(line);
+    }
+
+    size_t size() const {
+        return offsets.size();
+    }
+
+    string_view line(size_t i) const {
+        size_t end = i + 1 < offsets.size() ? offsets[i + 1] : chars.size();
+        return string_view(chars).substr(offsets[i], end - offsets[i]);
+    }
+
+    void writeSorted(BufferedFileWriter& out) const {
+        vector<uint32_t> positions;
+        birthdayPositions(keys, positions);
+        vector<uint32_t> order(positions.size());
+        for (size_t i = 0; i < positions.size(); i++) {
+            order[positions[i]] = static_cast<uint32_t>(i);
+        }
+        for (uint32_t i : order) {
+            out.writeLine(line(i));
+        }
+    }
+
+    void clear() {
+        chars.clear();
+        offsets.clear();
+        keys.clear();
+    }
+};
+
+// Merges sorted run files into `output`; ties go to the earlier run, so the merge is stable
+bool mergeBirthdayRuns(const vector<string>& runs, const string& output, size_t readBuffer,
+                       size_t writeBuffer, const string& header) {
+    struct Head {
+        uint16_t key;
+        size_t run;
+        bool operator>(const Head& other) const {
+            return key != other.key ? key > other.key : run > other.run;
+        }
+    };
+
+    BufferedFileWriter out(output, writeBuffer);
+    if (!out.isOpen()) {
+        cerr << "Error creating file " << output << endl;
+        return false;
+    }
+    if (!header.empty()) {
+        out.writeLine(header);
+    }
+
+    vector<unique_ptr<BufferedLineReader>> readers;
+    vector<string_view> current(runs.size());
+    priority_queue<Head, vector<Head>, greater<Head>> heads;
+
+    auto advance = [&](size_t run) {
+        uint16_t key;
+        while (readers[run]->next(current[run])) {
+            if (rowBirthdayKey(current[run], key)) {
+                heads.push({key, run});
+                return;
+            }
+        }
+    };
+
+    for (size_t run = 0; run < runs.size(); run++) {
+        readers.push_back(make_unique<BufferedLineReader>(runs[run], readBuffer));
+        if (!readers[run]->isOpen()) {
+            cerr << "Error opening run " << runs[run] << endl;
+            return false;
+        }
+        advance(run);
+    }
+
+    while (!heads.empty()) {
+        size_t run = heads.top().run;
+        heads.pop();
+        out.writeLine(current[run]);
+        advance(run);
+    }
+    return out.close();
+}
+
+// Sorts a students CSV by (month, day) with bounded memory: the input is cut into runs
+// that fit the budget, each run is counting-sorted and written to a temp file, and the
+// runs are k-way merged (in several passes if one pass would need too many buffers).
+// Output rows are the input lines unchanged, in the same order as sortByBirthday.
+// Lines that do not parse as a student row are left out and counted in
+// stats.skippedRows, as the CSV loaders skip them before an in-memory sort.
+bool externalSortByBirthday(const string& input, const string& output,
+                            const ExternalSortOptions& options, ExternalSortStats& stats) {
+    const size_t kMinMergeBuffer = 256 << 10;
+
+    stats = ExternalSortStats();
+    auto startTime = chrono::steady_clock::now();
+    size_t budget = max<size_t>(options.memoryBudget, 4 * kMinMergeBuffer);
+    size_t ioBuffer = max<size_t>(budget / 16, 64 << 10);
+    size_t runBudget = budget - 2 * ioBuffer;
+
+    BufferedLineReader reader(input, ioBuffer);
+    if (!reader.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return false;
+    }
+
+    string header;
+    string_view line;
+    if (reader.next(line)) {
+        header.assign(line);
+        stats.bytes += line.size() + 1;
+    }
+
+    string tempPrefix = options.tempDir + "/external_sort_" + to_string(getpid()) + "_";
+    size_t tempCount = 0;
+    vector<string> runs;
+    auto removeRuns = [](const vector<string>& files) {
+        for (const auto& file : files) {
+            remove(file.c_str());
+        }
+    };
+
+    // Phase 1: sorted runs
+    SortRun run(runBudget);
+    auto flushRun = [&]() {
+        if (run.size() == 0) return true;
+        string path = tempPrefix + to_string(tempCount++) + ".run";
+        BufferedFileWriter out(path, ioBuffer);
+        if (!out.isOpen()) {
+            cerr << "Error creating file " << path << endl;
+            return false;
+        }
+        run.writeSorted(out);
+        runs.push_back(path);
+        run.clear();
+        return out.close();
+    };
+
+    bool ok = true;
+    while (ok && reader.next(line)) {
+        stats.bytes += line.size() + 1;
+        uint16_t key;
+        if (!rowBirthdayKey(line, key)) {
+            stats.skippedRows++;
+            continue;
+        }
+
+        if (!run.fits(line.size()) && run.size() > 0) {
+            ok = flushRun();
+        }
+        run.add(line, key);
+        stats.rows++;
+    }
+    ok = ok && flushRun();
+    run = SortRun(0);
+    stats.runs = runs.size();
+
+    // Phase 2: merge passes until one pass can write the output. Every pass holds one
+    // write buffer plus one read buffer per input run.
+    size_t readBudget = budget - ioBuffer;
+    size_t fanout = max<size_t>(2, readBudget / kMinMergeBuffer);
+    while (ok && runs.size() > fanout) {
+        vector<string> merged;
+        size_t first = 0;
+        for (; ok && first < runs.size(); first += fanout) {
+            vector<string> group(runs.begin() + first, runs.begin() + min(runs.size(), first + fanout));
+            string path = tempPrefix + to_string(tempCount++) + ".run";
+            ok = mergeBirthdayRuns(group, path, readBudget / group.size(), ioBuffer, "");
+            merged.push_back(path);
+            removeRuns(group);
+        }
+        // Runs this pass did not reach after a failure; the merged ones are removed below
+        if (first < runs.size()) {
+            removeRuns(vector<string>(runs.begin() + first, runs.end()));
+        }
+        runs = merged;
+        stats.mergePasses++;
+    }
+
+    if (ok) {
+        size_t readBuffer = runs.empty() ? ioBuffer : min(readBudget / runs.size(), 4 * ioBuffer);
+        ok = mergeBirthdayRuns(runs, output, readBuffer, ioBuffer, header);
+        stats.mergePasses++;
+    }
+    removeRuns(runs);
+
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    return ok;
+}
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,162 @@
+#ifndef FLAT_EMAIL_INDEX_H
+#define FLAT_EMAIL_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Open-addressing email -> record index table in the style of Swiss tables.
+// One control byte per slot holds 7 bits of the hash (or "empty"); lookups scan
+// a group of 16 control bytes with one SSE2 compare and only touch the slot array
+// (cached 32-bit hash + record index, 8 bytes) for candidate matches, and the record
+// itself once. Records live in the caller's contiguous vector; the table never
+// stores keys. Insert-only: students are never removed.
+class FlatEmailIndex {
+private:
+    static constexpr size_t kGroupWidth = 16;
+    static constexpr int8_t kEmpty = -128;
+
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;
+    };
+
+    vector<int8_t> ctrl;
+    vector<Slot> slots;
+    size_t groupMask = 0;
+    size_t count = 0;
+
+    static int8_t h2(uint32_t hash) {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    size_t firstGroup(uint32_t hash) const {
+        return (hash >> 7) & groupMask;
+    }
+
+    // Bit i set where ctrl[group * 16 + i] == value
+    uint32_t matchByte(size_t group, int8_t value) const {
+        const int8_t* bytes = ctrl.data() + group * kGroupWidth;
+#if defined(__SSE2__)
+        __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kGroupWidth; i++) {
+            if (bytes[i] == value) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    void insertUnchecked(uint32_t hash, uint32_t index) {
+        size_t group = firstGroup(hash);
+        for (size_t step = 1;; step++) {
+            uint32_t empty = matchByte(group, kEmpty);
+            if (empty) {
+                size_t pos = group * kGroupWidth + __builtin_ctz(empty);
+                ctrl[pos] = h2(hash);
+                slots[pos] = {hash, index};
+                return;
+            }
+            group = (group + step) & groupMask;  // triangular probing visits every group
+        }
+    }
+
+    void rehash(size_t groups) {
+        vector<int8_t> oldCtrl = move(ctrl);
+        vector<Slot> oldSlots = move(slots);
+
+        ctrl.assign(groups * kGroupWidth, kEmpty);
+        slots.assign(groups * kGroupWidth, Slot{0, 0});
+        groupMask = groups - 1;
+
+        for (size_t pos = 0; pos < oldCtrl.size(); pos++) {
+            if (oldCtrl[pos] != kEmpty) {
+                insertUnchecked(oldSlots[pos].hash, oldSlots[pos].index);
+            }
+        }
+    }
+
+    static size_t groupsFor(size_t entries) {
+        size_t groups = 1;
+        while (groups * kGroupWidth * 7 / 8 < entries) {
+            groups *= 2;
+        }
+        return groups;
+    }
+
+public:
+    static constexpr uint32_t kNotFound = UINT32_MAX;
+
+    static uint32_t hashEmail(string_view email) {
+        size_t h = hash<string_view>()(email);
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+    FlatEmailIndex() {
+        rehash(1);
+    }
+
+    void reserve(size_t entries) {
+        size_t groups = groupsFor(entries);
+        if (groups > groupMask + 1) {
+            rehash(groups);
+        }
+    }
+
+    // Caller guarantees the email is not in the table yet
+    void insert(uint32_t hash, uint32_t index) {
+        if ((count + 1) > (groupMask + 1) * kGroupWidth * 7 / 8) {
+            rehash((groupMask + 1) * 2);
+        }
+        insertUnchecked(hash, index);
+        count++;
+    }
+
+    // Returns the record index or kNotFound; Record needs an m_email member
+    template <class Record>
+    uint32_t find(string_view email, uint32_t hash, const vector<Record>& records) const {
+        size_t group = firstGroup(hash);
+        for (size_t step = 1;; step++) {
+            uint32_t candidates = matchByte(group, h2(hash));
+            while (candidates) {
+                size_t pos = group * kGroupWidth + __builtin_ctz(candidates);
+                const Slot& slot = slots[pos];
+                if (slot.hash == hash && records[slot.index].m_email == email) {
+                    return slot.index;
+                }
+                candidates &= candidates - 1;
+            }
+            if (matchByte(group, kEmpty)) {
+                return kNotFound;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    template <class Record>
+    uint32_t find(string_view email, const vector<Record>& records) const {
+        return find(email, hashEmail(email), records);
+    }
+
+    // Pulls the first probe group into cache ahead of a find with the same hash
+    void prefetch(uint32_t hash) const {
+        size_t pos = firstGroup(hash) * kGroupWidth;
+        __builtin_prefetch(ctrl.data() + pos);
+        __builtin_prefetch(slots.data() + pos);
+    }
+
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // FLAT_EMAIL_INDEX_H
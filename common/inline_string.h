@@ -0,0 +1,155 @@
+#ifndef INLINE_STRING_H
+#define INLINE_STRING_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// String with room for Capacity chars inside the object; longer values fall back
+// to one heap buffer. With Capacity sized to the data (names, groups, phones and
+// emails of this repo) copies and loads never allocate. Not null-terminated.
+template <size_t Capacity>
+class InlineString {
+private:
+    uint32_t length = 0;
+    uint32_t heapCapacity = 0;  // 0 = chars are stored inline
+    union {
+        char local[Capacity];
+        char* heap;
+    };
+
+    bool onHeap() const {
+        return heapCapacity != 0;
+    }
+
+    void release() {
+        if (onHeap()) {
+            delete[] heap;
+            heapCapacity = 0;
+        }
+    }
+
+    void stealFrom(InlineString& other) {
+        length = other.length;
+        heapCapacity = other.heapCapacity;
+        if (other.onHeap()) {
+            heap = other.heap;
+            other.heapCapacity = 0;
+        } else {
+            memcpy(local, other.local, length);
+        }
+        other.length = 0;
+    }
+
+public:
+    InlineString() {}
+
+    InlineString(string_view value) {
+        assign(value);
+    }
+
+    InlineString(const char* value) {
+        assign(string_view(value));
+    }
+
+    InlineString(const InlineString& other) {
+        assign(other.view());
+    }
+
+    InlineString(InlineString&& other) noexcept {
+        stealFrom(other);
+    }
+
+    InlineString& operator=(const InlineString& other) {
+        if (this != &other) {
+            assign(other.view());
+        }
+        return *this;
+    }
+
+    InlineString& operator=(InlineString&& other) noexcept {
+        if (this != &other) {
+            release();
+            stealFrom(other);
+        }
+        return *this;
+    }
+
+    InlineString& operator=(string_view value) {
+        assign(value);
+        return *this;
+    }
+
+    InlineString& operator=(const char* value) {
+        assign(string_view(value));
+        return *this;
+    }
+
+    // Not release(): GCC splits its cold path out and folds the copies for different
+    // capacities into one, which -Warray-bounds then reports as out-of-bounds
+    ~InlineString() {
+        if (onHeap()) delete[] heap;
+    }
+
+    void assign(string_view value) {
+        if (onHeap() && value.size() <= heapCapacity) {
+            memmove(heap, value.data(), value.size());
+        } else if (value.size() <= Capacity) {
+            memmove(local, value.data(), value.size());
+        } else {
+            char* buffer = new char[value.size()];
+            memcpy(buffer, value.data(), value.size());
+            release();
+            heap = buffer;
+            heapCapacity = static_cast<uint32_t>(value.size());
+        }
+        length = static_cast<uint32_t>(value.size());
+    }
+
+    const char* data() const {
+        return onHeap() ? heap : local;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool empty() const {
+        return length == 0;
+    }
+
+    string_view view() const {
+        return string_view(data(), length);
+    }
+
+    string str() const {
+        return string(data(), length);
+    }
+
+    operator string_view() const {
+        return view();
+    }
+
+    operator string() const {
+        return str();
+    }
+
+    friend bool operator==(const InlineString& a, const InlineString& b) { return a.view() == b.view(); }
+    friend bool operator==(const InlineString& a, const string& b) { return a.view() == b; }
+    friend bool operator==(const string& a, const InlineString& b) { return a == b.view(); }
+    friend bool operator==(const InlineString& a, const char* b) { return a.view() == b; }
+    friend bool operator!=(const InlineString& a, const InlineString& b) { return !(a == b); }
+    friend bool operator!=(const InlineString& a, const string& b) { return !(a == b); }
+    friend bool operator!=(const string& a, const InlineString& b) { return !(a == b); }
+    friend bool operator<(const InlineString& a, const InlineString& b) { return a.view() < b.view(); }
+
+    friend ostream& operator<<(ostream& out, const InlineString& value) {
+        return out << value.view();
+    }
+};
+
+#endif // INLINE_STRING_H
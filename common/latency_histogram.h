@@ -0,0 +1,123 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+// Cheapest available timestamp: the TSC on x86 (a few ns to read, constant rate on
+// every CPU of the last decade), steady_clock elsewhere. ticksPerSecond() is measured
+// once against steady_clock.
+class CycleClock {
+public:
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return chrono::duration_cast<chrono::nanoseconds>(
+                   chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static double ticksPerSecond() {
+        static const double rate = calibrate();
+        return rate;
+    }
+
+private:
+    static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wallStart = chrono::steady_clock::now();
+        uint64_t tickStart = now();
+        while (chrono::steady_clock::now() - wallStart < chrono::milliseconds(20)) {
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+        return (now() - tickStart) / seconds;
+#else
+        return 1e9;
+#endif
+    }
+};
+
+// HDR-style histogram: values below 2^(kSubBits + 1) are counted exactly, larger ones in
+// 2^kSubBits linear sub-buckets per power of two, so every recorded value is known to
+// within 1/2^kSubBits (about 3%) at a fixed 15 KB of counters. record() is a few
+// shifts and one increment.
+class LatencyHistogram {
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kMaxShift = 63 - kSubBits;
+
+    vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+    double sum = 0.0;
+
+    // Values are split by their top kSubBits + 1 bits: bucket = shift * 32 + (value >> shift)
+    static size_t bucketOf(uint64_t value) {
+        int shift = value < 2 * kSubBuckets ? 0 : 63 - __builtin_clzll(value) - kSubBits;
+        return size_t(shift) * kSubBuckets + (value >> shift);
+    }
+
+    // Largest value that falls into the bucket
+    static uint64_t bucketHigh(size_t bucket) {
+        size_t shift = bucket < 2 * kSubBuckets ? 0 : bucket / kSubBuckets - 1;
+        uint64_t top = bucket - shift * kSubBuckets;
+        return ((top + 1) << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() : counts((kMaxShift + 2) * kSubBuckets, 0) {}
+
+    void record(uint64_t value) {
+        counts[bucketOf(value)]++;
+        total++;
+        maxValue = std::max(maxValue, value);
+        sum += value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        maxValue = std::max(maxValue, other.maxValue);
+        sum += other.sum;
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    uint64_t max() const {
+        return maxValue;
+    }
+
+    double mean() const {
+        return total > 0 ? sum / total : 0.0;
+    }
+
+    // Smallest bucket bound that at least `fraction` of the values are <= (0.99 = p99)
+    uint64_t percentile(double fraction) const {
+        if (total == 0) return 0;
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(fraction * total + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(bucketHigh(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
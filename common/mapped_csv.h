@@ -0,0 +1,263 @@
+#ifndef MAPPED_CSV_H
+#define MAPPED_CSV_H
+
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+
+public:
+    explicit MappedFile(const string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            m_size = info.st_size;
+            if (m_size == 0) {
+                m_open = true;
+            } else {
+                void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    madvise(mapped, m_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<const char*>(mapped);
+                    m_open = true;
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (m_data) munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_open; }
+    const char* begin() const { return m_data; }
+    const char* end() const { return m_data + m_size; }
+    size_t size() const { return m_size; }
+};
+
+// One CSV row; the string fields point into the mapped file
+struct StudentRow {
+    string_view name;
+    string_view surname;
+    string_view email;
+    int birthYear;
+    int birthMonth;
+    int birthDay;
+    string_view group;
+    double rating;
+    string_view phone;
+};
+
+// A record of any Student type with the standard field names (std::string or the
+// inline string types) from a parsed row, e.g. parseCSVParallel<Student>(file, 0, makeStudent<Student>)
+template <class StudentT>
+StudentT makeStudent(const StudentRow& row) {
+    StudentT student;
+    student.m_name.assign(row.name);
+    student.m_surname.assign(row.surname);
+    student.m_email.assign(row.email);
+    student.m_birth_year = row.birthYear;
+    student.m_birth_month = row.birthMonth;
+    student.m_birth_day = row.birthDay;
+    student.m_group.assign(row.group);
+    student.m_rating = row.rating;
+    student.m_phone_number.assign(row.phone);
+    return student;
+}
+
+struct LoadStats {
+    size_t rows = 0;
+    size_t bytes = 0;
+    double seconds = 0.0;
+
+    double rowsPerSecond() const {
+        return seconds > 0 ? rows / seconds : 0.0;
+    }
+
+    double megabytesPerSecond() const {
+        return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
+template <class T>
+bool parseNumber(string_view field, T& value) {
+    auto result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc();
+}
+
+// Splits a line into at most N comma-separated fields, returns how many were found
+template <size_t N>
+size_t splitCSVRow(string_view line, string_view (&fields)[N]) {
+    size_t count = 0;
+    size_t start = 0;
+
+    while (count < N) {
+        size_t comma = line.find(',', start);
+        if (comma == string_view::npos) {
+            fields[count++] = line.substr(start);
+            break;
+        }
+        fields[count++] = line.substr(start, comma - start);
+        start = comma + 1;
+    }
+    return count;
+}
+
+bool parseStudentRow(string_view line, StudentRow& row) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    string_view fields[9];
+    if (splitCSVRow(line, fields) < 9) {
+        return false;
+    }
+
+    row.name = fields[0];
+    row.surname = fields[1];
+    row.email = fields[2];
+    row.group = fields[6];
+    row.phone = fields[8];
+
+    return parseNumber(fields[3], row.birthYear) &&
+           parseNumber(fields[4], row.birthMonth) &&
+           parseNumber(fields[5], row.birthDay) &&
+           parseNumber(fields[7], row.rating);
+}
+
+// Returns the first byte after the header line
+const char* skipCSVHeader(const char* begin, const char* end) {
+    const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    return newline ? newline + 1 : end;
+}
+
+size_t countLines(const char* begin, const char* end) {
+    size_t lines = 0;
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        lines++;
+        if (!newline) break;
+        begin = newline + 1;
+    }
+    return lines;
+}
+
+// Calls callback(string_view) for every line in [begin, end)
+template <class Callback>
+void forEachLine(const char* begin, const char* end, Callback&& callback) {
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        const char* lineEnd = newline ? newline : end;
+        callback(string_view(begin, lineEnd - begin));
+        begin = lineEnd + 1;
+    }
+}
+
+unsigned defaultThreadCount() {
+    unsigned threads = thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+// Cuts [begin, end) into at most `parts` pieces that start and end on line boundaries
+vector<pair<const char*, const char*>> splitAtLines(const char* begin, const char* end, unsigned parts) {
+    vector<pair<const char*, const char*>> chunks;
+    size_t total = end - begin;
+    if (parts == 0) parts = 1;
+
+    const char* chunkBegin = begin;
+    for (unsigned i = 1; i <= parts && chunkBegin < end; i++) {
+        const char* chunkEnd = i == parts ? end : begin + total * i / parts;
+        if (chunkEnd < chunkBegin) {
+            chunkEnd = chunkBegin;
+        }
+        if (chunkEnd < end) {
+            const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks.push_back({chunkBegin, chunkEnd});
+        chunkBegin = chunkEnd;
+    }
+    return chunks;
+}
+
+// Runs parseChunk(index, begin, end) for every chunk, one worker thread per chunk
+template <class ChunkFn>
+void parallelForChunks(const vector<pair<const char*, const char*>>& chunks, ChunkFn&& parseChunk) {
+    vector<thread> workers;
+    workers.reserve(chunks.size());
+
+    for (size_t i = 1; i < chunks.size(); i++) {
+        workers.emplace_back([&, i]() {
+            parseChunk(i, chunks[i].first, chunks[i].second);
+        });
+    }
+    if (!chunks.empty()) {
+        parseChunk(0, chunks[0].first, chunks[0].second);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Runs fn(t, begin, end) on `threads` workers, worker t getting the t-th contiguous slice of [0, n)
+template <class Fn>
+void forEachSlice(size_t n, unsigned threads, Fn&& fn) {
+    vector<thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            fn(t, n * t / threads, n * (t + 1) / threads);
+        });
+    }
+    fn(0, 0, n / threads);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Parses the data rows of a mapped CSV on `threads` workers; rows[i] holds chunk i in file order
+template <class Record, class MakeRecord>
+vector<vector<Record>> parseCSVParallel(const MappedFile& file, unsigned threads, MakeRecord&& makeRecord) {
+    const char* begin = skipCSVHeader(file.begin(), file.end());
+    auto chunks = splitAtLines(begin, file.end(), threads > 0 ? threads : defaultThreadCount());
+    vector<vector<Record>> rows(chunks.size());
+
+    parallelForChunks(chunks, [&](size_t index, const char* chunkBegin, const char* chunkEnd) {
+        vector<Record>& out = rows[index];
+        out.reserve(countLines(chunkBegin, chunkEnd));
+
+        StudentRow row;
+        forEachLine(chunkBegin, chunkEnd, [&](string_view line) {
+            if (parseStudentRow(line, row)) {
+                out.push_back(makeRecord(row));
+            }
+        });
+    });
+
+    return rows;
+}
+
+#endif // MAPPED_CSV_H
@@ -0,0 +1,85 @@
+#ifndef OBJECT_ARENA_H
+#define OBJECT_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Bump allocator for objects of one type. Memory is taken in blocks of BlockSize
+// objects and released all at once, so building N objects costs N / BlockSize
+// allocations and teardown never walks a pointer structure.
+// Objects cannot be freed one by one; clear() destroys everything.
+template <class T, size_t BlockSize = 4096>
+class ObjectArena {
+private:
+    vector<T*> blocks;
+    size_t usedInLast = BlockSize;  // objects constructed in blocks.back()
+
+public:
+    ObjectArena() = default;
+
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    ObjectArena(ObjectArena&& other) noexcept
+        : blocks(move(other.blocks)), usedInLast(other.usedInLast) {
+        other.blocks.clear();
+        other.usedInLast = BlockSize;
+    }
+
+    ObjectArena& operator=(ObjectArena&& other) noexcept {
+        if (this != &other) {
+            clear();
+            blocks = move(other.blocks);
+            usedInLast = other.usedInLast;
+            other.blocks.clear();
+            other.usedInLast = BlockSize;
+        }
+        return *this;
+    }
+
+    ~ObjectArena() {
+        clear();
+    }
+
+    template <class... Args>
+    T* create(Args&&... args) {
+        if (usedInLast == BlockSize) {
+            blocks.push_back(allocator<T>().allocate(BlockSize));
+            usedInLast = 0;
+        }
+        T* object = blocks.back() + usedInLast;
+        new (object) T(forward<Args>(args)...);
+        usedInLast++;
+        return object;
+    }
+
+    void clear() {
+        for (size_t b = 0; b < blocks.size(); b++) {
+            if (!is_trivially_destructible<T>::value) {
+                size_t used = b + 1 == blocks.size() ? usedInLast : BlockSize;
+                for (size_t i = 0; i < used; i++) {
+                    blocks[b][i].~T();
+                }
+            }
+            allocator<T>().deallocate(blocks[b], BlockSize);
+        }
+        blocks.clear();
+        usedInLast = BlockSize;
+    }
+
+    size_t size() const {
+        return blocks.empty() ? 0 : (blocks.size() - 1) * BlockSize + usedInLast;
+    }
+
+    size_t blockCount() const {
+        return blocks.size();
+    }
+};
+
+#endif // OBJECT_ARENA_H
@@ -0,0 +1,148 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+enum PerfCounter {
+    kPerfCycles,
+    kPerfInstructions,
+    kPerfLLCMisses,     // the kernel's generic cache-misses event, last-level cache on x86
+    kPerfBranchMisses,
+    kPerfPageFaults,
+    kPerfCounterCount
+};
+
+const char* const kPerfCounterNames[kPerfCounterCount] = {
+    "cycles", "instructions", "llc_misses", "branch_misses", "page_faults"};
+
+// Counts between start() and stop(); counters that could not be opened are not `has`
+struct PerfSample {
+    uint64_t value[kPerfCounterCount] = {};
+    bool has[kPerfCounterCount] = {};
+};
+
+// User-space hardware and software counters of the calling thread, via perf_event_open.
+// Each counter is opened on its own, so whatever the machine allows is counted: VMs and
+// containers often have no PMU, or perf_event_paranoid forbids it, while page faults
+// (a software event) still work. Counters the kernel multiplexes are scaled up by
+// time enabled / time running. error() names the counters that are missing and why.
+class PerfCounters {
+private:
+    int fds[kPerfCounterCount];
+    string missing;
+
+#if defined(__linux__)
+    struct ReadFormat {
+        uint64_t value;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+    };
+
+    static int openCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+        for (int& fd : fds) {
+            fd = -1;
+        }
+#if defined(__linux__)
+        const pair<uint32_t, uint64_t> events[kPerfCounterCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}};
+        string reason;
+        for (int i = 0; i < kPerfCounterCount; i++) {
+            fds[i] = openCounter(events[i].first, events[i].second);
+            if (fds[i] < 0) {
+                missing += string(missing.empty() ? "" : ", ") + kPerfCounterNames[i];
+                if (reason.empty()) reason = strerror(errno);
+            }
+        }
+        if (!missing.empty()) {
+            missing += " unavailable (" + reason + ")";
+        }
+#else
+        missing = "perf_event_open needs Linux";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    // Empty if every counter is there
+    const string& error() const {
+        return missing;
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    PerfSample stop() {
+        PerfSample sample;
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int i = 0; i < kPerfCounterCount; i++) {
+            ReadFormat data;
+            if (fds[i] < 0 || read(fds[i], &data, sizeof(data)) != ssize_t(sizeof(data))) continue;
+            sample.has[i] = true;
+            sample.value[i] = data.timeRunning > 0 && data.timeRunning < data.timeEnabled
+                                  ? uint64_t(double(data.value) * data.timeEnabled / data.timeRunning)
+                                  : data.value;
+        }
+#endif
+        return sample;
+    }
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,150 @@
+#ifndef STUDENT_COLUMNS_H
+#define STUDENT_COLUMNS_H
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Column-oriented copy of a roster for full scans: one contiguous array per field
+class StudentColumns {
+private:
+    unordered_map<string, uint32_t> groupIdsByName;
+
+public:
+    vector<uint32_t> groupIds;
+    vector<double> ratings;
+    vector<uint8_t> birthMonths;
+    vector<uint8_t> birthDays;
+    vector<uint64_t> emailOffsets{0};  // email i is emailChars[emailOffsets[i], emailOffsets[i + 1])
+    string emailChars;
+    vector<string> groupNames;         // indexed by group id
+
+    // Works with any Student type of this repo (they share field names)
+    template <class StudentT>
+    void add(const StudentT& student) {
+        groupIds.push_back(internGroup(student.m_group));
+        ratings.push_back(student.m_rating);
+        birthMonths.push_back(static_cast<uint8_t>(student.m_birth_month));
+        birthDays.push_back(static_cast<uint8_t>(student.m_birth_day));
+        emailChars += student.m_email;
+        emailOffsets.push_back(emailChars.size());
+    }
+
+    void reserve(size_t students) {
+        groupIds.reserve(students);
+        ratings.reserve(students);
+        birthMonths.reserve(students);
+        birthDays.reserve(students);
+        emailOffsets.reserve(students + 1);
+    }
+
+    uint32_t internGroup(const string& name) {
+        auto inserted = groupIdsByName.try_emplace(name, static_cast<uint32_t>(groupNames.size()));
+        if (inserted.second) {
+            groupNames.push_back(name);
+        }
+        return inserted.first->second;
+    }
+
+    void setGroup(size_t index, const string& group) {
+        groupIds[index] = internGroup(group);
+    }
+
+    size_t size() const {
+        return groupIds.size();
+    }
+
+    size_t groupCount() const {
+        return groupNames.size();
+    }
+
+    string_view email(size_t index) const {
+        return string_view(emailChars).substr(emailOffsets[index], emailOffsets[index + 1] - emailOffsets[index]);
+    }
+};
+
+// Count/sum-by-group kernels. A histogram indexed by group id is a scatter. Per-lane
+// histograms with AVX2 gathers or an AVX-512 scatter were no faster than these loops
+// and up to 6x slower, so the kernels stay scalar. Rows are summed in order, so
+// averages match the row-based scans.
+
+void countByGroup(const StudentColumns& columns, vector<uint32_t>& counts) {
+    counts.assign(columns.groupCount(), 0);
+    const uint32_t* ids = columns.groupIds.data();
+    for (size_t i = 0; i < columns.size(); i++) {
+        counts[ids[i]]++;
+    }
+}
+
+void countAndSumByGroup(const StudentColumns& columns, vector<uint32_t>& counts, vector<double>& sums) {
+    counts.assign(columns.groupCount(), 0);
+    sums.assign(columns.groupCount(), 0.0);
+    const uint32_t* ids = columns.groupIds.data();
+    const double* ratings = columns.ratings.data();
+    for (size_t i = 0; i < columns.size(); i++) {
+        counts[ids[i]]++;
+        sums[ids[i]] += ratings[i];
+    }
+}
+
+// Quiet versions for benchmarks; ties go to the lowest group id
+uint32_t groupIdWithMostStudents(const StudentColumns& columns, uint32_t& maxCount) {
+    vector<uint32_t> counts;
+    countByGroup(columns, counts);
+
+    uint32_t best = 0;
+    maxCount = 0;
+    for (uint32_t id = 0; id < counts.size(); id++) {
+        if (counts[id] > maxCount) {
+            maxCount = counts[id];
+            best = id;
+        }
+    }
+    return best;
+}
+
+uint32_t groupIdWithHighestRating(const StudentColumns& columns, double& maxAvgRating) {
+    vector<uint32_t> counts;
+    vector<double> sums;
+    countAndSumByGroup(columns, counts, sums);
+
+    uint32_t best = 0;
+    maxAvgRating = 0.0;
+    for (uint32_t id = 0; id < counts.size(); id++) {
+        double avgRating = counts[id] > 0 ? sums[id] / counts[id] : 0.0;
+        if (avgRating > maxAvgRating) {
+            maxAvgRating = avgRating;
+            best = id;
+        }
+    }
+    return best;
+}
+
+string findGroupWithMostStudents(const StudentColumns& columns) {
+    if (columns.size() == 0) return "";
+
+    uint32_t maxCount;
+    const string& maxGroup = columns.groupNames[groupIdWithMostStudents(columns, maxCount)];
+
+    cout << "Group " << maxGroup << " has the most students: " << maxCount << endl;
+    return maxGroup;
+}
+
+string findGroupWithHighestRating(const StudentColumns& columns) {
+    if (columns.size() == 0) return "";
+
+    double maxAvgRating;
+    const string& bestGroup = columns.groupNames[groupIdWithHighestRating(columns, maxAvgRating)];
+
+    cout << "Group " << bestGroup << " has the highest average rating: "
+         << fixed << setprecision(2) << maxAvgRating << endl;
+    return bestGroup;
+}
+
+#endif // STUDENT_COLUMNS_H
@@ -0,0 +1,228 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Zipf-distributed ranks in [0, n): rank 0 is the most popular and P(k) ~ 1 / (k + 1)^theta.
+// Gray et al.'s method, as in YCSB: O(n) once for the zeta constant, then one pow per
+// sample. Needs 0 < theta < 1; YCSB's default of 0.99 puts ~60% of all draws on the
+// top 1% of 200k keys.
+class ZipfianDistribution {
+private:
+    size_t n;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+    double secondThreshold;
+
+public:
+    ZipfianDistribution(size_t count, double skew) : n(max<size_t>(count, 1)), theta(skew) {
+        zetan = 0.0;
+        for (size_t i = 1; i <= n; i++) {
+            zetan += 1.0 / pow(double(i), theta);
+        }
+        double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+        secondThreshold = 1.0 + pow(0.5, theta);
+    }
+
+    template <class Generator>
+    size_t operator()(Generator& gen) {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(gen);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < secondThreshold) return min<size_t>(1, n - 1);
+        return min<size_t>(size_t(n * pow(eta * u - eta + 1.0, alpha)), n - 1);
+    }
+};
+
+// Picks keys in [0, n): uniformly for skew 0, otherwise Zipfian with theta = skew.
+// Ranks go through a fixed shuffle, so the hot keys are scattered over the key space
+// (not the alphabetically first emails) and are the same for every seed and backend.
+class KeyChooser {
+private:
+    uniform_int_distribution<size_t> uniform;
+    vector<ZipfianDistribution> zipf;  // empty when uniform
+    vector<uint32_t> keyOfRank;
+
+public:
+    KeyChooser(size_t count, double skew) : uniform(0, max<size_t>(count, 1) - 1) {
+        if (skew > 0.0 && count > 1) {
+            zipf.emplace_back(count, skew);
+            keyOfRank.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                keyOfRank[i] = uint32_t(i);
+            }
+            mt19937_64 shuffleGen(0x5eed5eedULL);
+            shuffle(keyOfRank.begin(), keyOfRank.end(), shuffleGen);
+        }
+    }
+
+    template <class Generator>
+    size_t operator()(Generator& gen) {
+        return zipf.empty() ? uniform(gen) : keyOfRank[zipf[0](gen)];
+    }
+};
+
+// A Zipf theta from the command line; ZipfianDistribution needs [0, 1)
+double parseSkew(const string& value) {
+    double skew = stod(value);
+    if (skew < 0.0 || skew >= 1.0) {
+        cerr << "Skew " << value << " is outside [0, 1), using 0" << endl;
+        return 0.0;
+    }
+    return skew;
+}
+
+struct WorkloadSpec {
+    uint32_t mix[3] = {5, 1, 100};  // Op1:Op2:Op3 weights; Op2 is the only write
+    double emailSkew = 0.0;         // Zipf theta of the changed emails, 0 = uniform
+    double groupSkew = 0.0;         // Zipf theta of the target groups, 0 = uniform
+};
+
+// Op1:Op2:Op3 weights from the command line, e.g. 5:1:100; a malformed or all-zero
+// mix leaves spec.mix as it was
+void parseMix(const string& value, WorkloadSpec& spec) {
+    uint32_t mix[3];
+    if (sscanf(value.c_str(), "%u:%u:%u", &mix[0], &mix[1], &mix[2]) != 3 || mix[0] + mix[1] + mix[2] == 0) {
+        cerr << "Mix " << value << " is not Op1:Op2:Op3, using " << spec.mix[0] << ":" << spec.mix[1] << ":"
+             << spec.mix[2] << endl;
+        return;
+    }
+    copy(mix, mix + 3, spec.mix);
+}
+
+enum WorkloadOpType : uint32_t {
+    kOpMostStudents,
+    kOpChangeGroup,
+    kOpHighestRating
+};
+
+// email and group are indices into the backend's sorted email and group lists;
+// they are only meaningful for kOpChangeGroup
+struct WorkloadOp {
+    uint32_t type;
+    uint32_t email;
+    uint32_t group;
+};
+
+// The same seed and spec give the same op sequence on every run and every backend
+class WorkloadGenerator {
+private:
+    WorkloadSpec spec;
+    mt19937_64 gen;
+    uniform_int_distribution<uint32_t> opDist;
+    KeyChooser emails;
+    KeyChooser groups;
+
+public:
+    WorkloadGenerator(const WorkloadSpec& workload, size_t emailCount, size_t groupCount, uint64_t seed)
+        : spec(workload), gen(seed),
+          opDist(1, max<uint32_t>(workload.mix[0] + workload.mix[1] + workload.mix[2], 1)),
+          emails(emailCount, workload.emailSkew), groups(groupCount, workload.groupSkew) {}
+
+    WorkloadOp next() {
+        uint32_t op = opDist(gen);
+        if (op <= spec.mix[0]) {
+            return {kOpMostStudents, 0, 0};
+        }
+        if (op <= spec.mix[0] + spec.mix[1]) {
+            uint32_t email = uint32_t(emails(gen));
+            return {kOpChangeGroup, email, uint32_t(groups(gen))};
+        }
+        return {kOpHighestRating, 0, 0};
+    }
+
+    vector<WorkloadOp> generate(size_t count) {
+        vector<WorkloadOp> ops(count);
+        for (auto& op : ops) {
+            op = next();
+        }
+        return ops;
+    }
+};
+
+// Trace file (native little-endian): TraceHeader, then opCount WorkloadOp records
+constexpr char kTraceMagic[8] = {'S', 'T', 'U', 'D', 'T', 'R', 'C', '1'};
+constexpr uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t seed;
+    uint32_t mix[3];
+    uint32_t reserved;
+    double emailSkew;
+    double groupSkew;
+    uint64_t emailCount;  // the dataset the indices refer to
+    uint64_t groupCount;
+    uint64_t opCount;
+};
+
+bool writeTrace(const string& filename, const WorkloadSpec& spec, uint64_t seed, size_t emailCount,
+                size_t groupCount, const vector<WorkloadOp>& ops) {
+    TraceHeader header{};
+    memcpy(header.magic, kTraceMagic, sizeof(kTraceMagic));
+    header.version = kTraceVersion;
+    header.headerSize = sizeof(TraceHeader);
+    header.seed = seed;
+    copy(spec.mix, spec.mix + 3, header.mix);
+    header.emailSkew = spec.emailSkew;
+    header.groupSkew = spec.groupSkew;
+    header.emailCount = emailCount;
+    header.groupCount = groupCount;
+    header.opCount = ops.size();
+
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error creating file " << filename << endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(ops.data()), ops.size() * sizeof(WorkloadOp));
+    return file.good();
+}
+
+// Reads a whole trace; ops that do not fit the counts in the header are rejected
+bool readTrace(const string& filename, TraceHeader& header, vector<WorkloadOp>& ops) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error opening file " << filename << endl;
+        return false;
+    }
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, kTraceMagic, sizeof(kTraceMagic)) != 0 || header.version != kTraceVersion ||
+        header.headerSize != sizeof(TraceHeader)) {
+        cerr << filename << " is not a workload trace" << endl;
+        return false;
+    }
+    ops.resize(header.opCount);
+    if (!file.read(reinterpret_cast<char*>(ops.data()), ops.size() * sizeof(WorkloadOp))) {
+        cerr << filename << " is truncated" << endl;
+        return false;
+    }
+    for (const auto& op : ops) {
+        if (op.type > kOpHighestRating ||
+            (op.type == kOpChangeGroup && (op.email >= header.emailCount || op.group >= header.groupCount))) {
+            cerr << filename << " has an invalid op" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // WORKLOAD_H
@@ -0,0 +1,285 @@
+#ifndef CHANGE_LOG_H
+#define CHANGE_LOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../common/mapped_csv.h"
+
+using namespace std;
+
+// Append-only log of group changes (Op2). File layout:
+//   8-byte magic | record | record | ...
+// record = uint32 checksum | uint16 email length | uint16 group length | email | group
+// The checksum covers lengths and bytes, so a torn write at the tail is detected on
+// replay and cut off. Records name the group, not its id, so replaying interns new
+// groups in the same order as the original run.
+constexpr char kChangeLogMagic[8] = {'S', 'T', 'U', 'D', 'W', 'A', 'L', '1'};
+
+// Longest email or group a record can hold (the lengths are 16-bit)
+constexpr size_t kMaxChangeLogField = UINT16_MAX;
+
+struct ChangeLogOptions {
+    chrono::microseconds syncInterval{2000};  // longest a change waits for its fsync
+    size_t batchBytes = 1 << 20;              // wake the flusher early once this much is pending
+};
+
+struct ChangeLogStats {
+    uint64_t records = 0;
+    uint64_t syncs = 0;
+    uint64_t bytes = 0;
+};
+
+inline uint32_t changeChecksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+// Calls apply(email, group) for every intact record in order. Returns the byte
+// length of the valid prefix (0 if the file is missing or not a change log).
+template <class ApplyFn>
+size_t replayChangeLog(const string& filename, ApplyFn&& apply, size_t& records) {
+    records = 0;
+    MappedFile file(filename);
+    if (!file.isOpen() || file.size() < sizeof(kChangeLogMagic) ||
+        memcmp(file.begin(), kChangeLogMagic, sizeof(kChangeLogMagic)) != 0) {
+        return 0;
+    }
+
+    const char* pos = file.begin() + sizeof(kChangeLogMagic);
+    while (file.end() - pos >= 8) {
+        uint32_t checksum;
+        uint16_t emailLength, groupLength;
+        memcpy(&checksum, pos, 4);
+        memcpy(&emailLength, pos + 4, 2);
+        memcpy(&groupLength, pos + 6, 2);
+        size_t payload = 4 + size_t(emailLength) + groupLength;
+        if (size_t(file.end() - pos - 4) < payload || changeChecksum(pos + 4, payload) != checksum) {
+            break;
+        }
+        apply(string_view(pos + 8, emailLength), string_view(pos + 8 + emailLength, groupLength));
+        records++;
+        pos += 4 + payload;
+    }
+    return pos - file.begin();
+}
+
+// Group commit: append() only encodes into a memory buffer; a flusher thread writes
+// everything pending and fdatasyncs once per syncInterval (or sooner when batchBytes
+// accumulate), so one fsync covers every change made since the previous one.
+// waitDurable(lsn) blocks until the change with that sequence number is on disk.
+class ChangeLog {
+private:
+    int fd = -1;
+    ChangeLogOptions options;
+
+    mutex lock;
+    condition_variable wakeFlusher;
+    condition_variable synced;
+    string pending;
+    uint64_t appended = 0;
+    uint64_t durable = 0;
+    bool stopping = false;
+    bool running = false;  // open() succeeded and close() has not run yet
+    bool failed = false;
+    ChangeLogStats stats;
+
+    mutex ioLock;  // orders writes of the flusher and sync()
+    thread flusher;
+
+    bool writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    // Writes out and syncs whatever is pending; returns false on an I/O error.
+    // A failed or short write leaves the file end unknown, so the log latches as failed:
+    // durable never advances again and later changes are dropped until open() starts
+    // a new log (after a checkpoint has saved them in a snapshot).
+    bool flushPending() {
+        lock_guard<mutex> io(ioLock);
+        string batch;
+        uint64_t upTo;
+        {
+            lock_guard<mutex> guard(lock);
+            if (failed) {
+                pending.clear();
+                return false;
+            }
+            batch.swap(pending);
+            upTo = appended;
+        }
+        if (upTo == durable) return true;
+
+        bool ok = writeAll(batch.data(), batch.size()) && fdatasync(fd) == 0;
+        {
+            lock_guard<mutex> guard(lock);
+            failed = !ok;
+            if (ok) {
+                durable = upTo;
+                stats.syncs++;
+                stats.bytes += batch.size();
+            }
+        }
+        synced.notify_all();
+        return ok;
+    }
+
+    void flushLoop() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            wakeFlusher.wait_for(guard, options.syncInterval, [&]() {
+                return stopping || pending.size() >= options.batchBytes;
+            });
+            if (pending.empty()) continue;
+            guard.unlock();
+            flushPending();
+            guard.lock();
+        }
+    }
+
+public:
+    ChangeLog() = default;
+    ChangeLog(const ChangeLog&) = delete;
+    ChangeLog& operator=(const ChangeLog&) = delete;
+
+    ~ChangeLog() {
+        close();
+    }
+
+    // Opens for appending after the first validBytes bytes (the prefix replay accepted);
+    // anything after it is a torn tail and is truncated. validBytes = 0 starts a new log.
+    // On failure the log is left failed: append refuses and waitDurable returns false.
+    bool open(const string& filename, size_t validBytes, const ChangeLogOptions& logOptions = {}) {
+        close();
+        options = logOptions;
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT, 0644);
+        bool ok = fd >= 0 && ftruncate(fd, validBytes) == 0 && lseek(fd, validBytes, SEEK_SET) >= 0;
+        if (ok && validBytes == 0) {
+            ok = writeAll(kChangeLogMagic, sizeof(kChangeLogMagic));
+        }
+        if (!ok || fdatasync(fd) != 0) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+            {
+                lock_guard<mutex> guard(lock);
+                failed = true;
+                pending.clear();
+            }
+            synced.notify_all();
+            return false;
+        }
+
+        // Sequence numbers keep counting across reopens, so an lsn handed out before a
+        // checkpoint stays valid; everything before it is in the snapshot or the old log
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = false;
+            failed = false;
+            running = true;
+            durable = appended;
+        }
+        flusher = thread([this]() { flushLoop(); });
+        return true;
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // True while append() takes changes: open and no write has failed
+    bool accepting() {
+        lock_guard<mutex> guard(lock);
+        return running && !failed;
+    }
+
+    // Buffers one change and returns its sequence number (from 1); not durable until synced.
+    // Returns 0 and buffers nothing if the log is not accepting or a value is longer
+    // than kMaxChangeLogField.
+    uint64_t append(string_view email, string_view group) {
+        if (email.size() > kMaxChangeLogField || group.size() > kMaxChangeLogField) {
+            return 0;
+        }
+        uint16_t emailLength = static_cast<uint16_t>(email.size());
+        uint16_t groupLength = static_cast<uint16_t>(group.size());
+        char prefix[8];
+        memcpy(prefix + 4, &emailLength, 2);
+        memcpy(prefix + 6, &groupLength, 2);
+
+        lock_guard<mutex> guard(lock);
+        if (!running || failed) {
+            return 0;
+        }
+        size_t start = pending.size();
+        pending.append(prefix, 8);
+        pending.append(email.data(), emailLength);
+        pending.append(group.data(), groupLength);
+        uint32_t checksum = changeChecksum(pending.data() + start + 4, pending.size() - start - 4);
+        memcpy(&pending[start], &checksum, 4);
+
+        stats.records++;
+        if (pending.size() >= options.batchBytes) {
+            wakeFlusher.notify_one();
+        }
+        return ++appended;
+    }
+
+    // Blocks until change `lsn` is on disk; false for lsn 0 (a refused append), or if
+    // the log failed or was closed before the change got there
+    bool waitDurable(uint64_t lsn) {
+        if (lsn == 0) return false;
+        unique_lock<mutex> guard(lock);
+        wakeFlusher.notify_one();
+        synced.wait(guard, [&]() { return durable >= lsn || failed || !running; });
+        return durable >= lsn;
+    }
+
+    // Makes every change appended so far durable, without waiting for the interval
+    bool sync() {
+        {
+            lock_guard<mutex> guard(lock);
+            if (!running) return false;
+        }
+        return flushPending();
+    }
+
+    void close() {
+        if (fd < 0) return;
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wakeFlusher.notify_one();
+        flusher.join();
+        flushPending();
+        ::close(fd);
+        fd = -1;
+        {
+            lock_guard<mutex> guard(lock);
+            running = false;
+        }
+        synced.notify_all();
+    }
+
+    ChangeLogStats getStats() {
+        lock_guard<mutex> guard(lock);
+        return stats;
+    }
+};
+
+#endif // CHANGE_LOG_H
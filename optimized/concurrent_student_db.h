@@ -0,0 +1,172 @@
+#ifndef CONCURRENT_STUDENT_DB_H
+#define CONCURRENT_STUDENT_DB_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "student_manager_o.h"
+#include "epoch.h"
+
+using namespace std;
+
+// Answers of Op1/Op3, immutable once published
+struct TopGroupsSnapshot {
+    string maxCountGroup;
+    string maxRatingGroup;
+    uint64_t version = 0;
+};
+
+// Thread-safe OptimizedStudentDB.
+// - Op1/Op3 read an epoch-published snapshot: no locks, never blocked by writers.
+// - The email map is never modified after loading, so lookups take no lock.
+//   Student records are guarded by striped locks (keyed by record address), so
+//   getStudent never waits for the stats mutex.
+// - Op2 locks the student's stripe, then the stats mutex for the O(log G)
+//   re-rank. Stats and rankings share one mutex because the winners are global,
+//   so Op2 calls run one at a time: this class scales Op1/Op3 readers, not writers.
+//   ShardedStudentDB is the variant whose Op2 scales with threads.
+class ConcurrentStudentDB {
+private:
+    static constexpr size_t kStripes = 64;
+
+    struct alignas(64) Stripe {
+        mutex lock;
+    };
+
+    OptimizedStudentDB db;
+    Stripe stripes[kStripes];
+    mutex statsMutex;
+    EpochDomain epochs;
+    atomic<const TopGroupsSnapshot*> snapshot{nullptr};
+
+    Stripe& stripeOf(const Student* student) {
+        return stripes[hash<const Student*>()(student) / sizeof(Student) % kStripes];
+    }
+
+    // Caller holds statsMutex
+    void publishIfChanged() {
+        const TopGroupsSnapshot* current = snapshot.load(memory_order_relaxed);
+        const string& maxCountGroup = db.findGroupWithMostStudents();
+        const string& maxRatingGroup = db.findGroupWithHighestRating();
+
+        if (current && current->maxCountGroup == maxCountGroup &&
+            current->maxRatingGroup == maxRatingGroup) {
+            return;
+        }
+
+        auto* next = new TopGroupsSnapshot{maxCountGroup, maxRatingGroup,
+                                           current ? current->version + 1 : 1};
+        snapshot.store(next, memory_order_release);
+        if (current) {
+            epochs.retire(current);
+        }
+    }
+
+public:
+    ConcurrentStudentDB() = default;
+    ConcurrentStudentDB(const ConcurrentStudentDB&) = delete;
+    ConcurrentStudentDB& operator=(const ConcurrentStudentDB&) = delete;
+
+    ~ConcurrentStudentDB() {
+        delete snapshot.load();
+    }
+
+    // Not thread-safe: load before sharing the object between threads
+    LoadStats loadFromCSV(const string& filename, unsigned threads = 0) {
+        LoadStats stats = db.loadFromCSVParallel(filename, threads);
+        lock_guard<mutex> lock(statsMutex);
+        publishIfChanged();
+        return stats;
+    }
+
+    string findGroupWithMostStudents() {
+        auto guard = epochs.pin();
+        const TopGroupsSnapshot* current = snapshot.load(memory_order_acquire);
+        return current ? current->maxCountGroup : string();
+    }
+
+    string findGroupWithHighestRating() {
+        auto guard = epochs.pin();
+        const TopGroupsSnapshot* current = snapshot.load(memory_order_acquire);
+        return current ? current->maxRatingGroup : string();
+    }
+
+    // Calls fn(const TopGroupsSnapshot&) on the current snapshot without copying it
+    template <class Fn>
+    void readSnapshot(Fn&& fn) {
+        auto guard = epochs.pin();
+        const TopGroupsSnapshot* current = snapshot.load(memory_order_acquire);
+        if (current) fn(*current);
+    }
+
+    bool changeGroupByEmail(const string& email, uint32_t newGroupId) {
+        Student* student = db.findStudent(email);
+        if (!student) {
+            return false;
+        }
+
+        lock_guard<mutex> stripeLock(stripeOf(student).lock);
+        lock_guard<mutex> statsLock(statsMutex);
+        if (newGroupId >= db.groupCount()) {
+            return false;
+        }
+        db.moveStudent(*student, newGroupId);
+        publishIfChanged();
+        return true;
+    }
+
+    bool changeGroupByEmail(const string& email, const string& newGroup) {
+        uint32_t groupId;
+        {
+            lock_guard<mutex> statsLock(statsMutex);
+            groupId = db.internGroupName(newGroup);
+        }
+        return changeGroupByEmail(email, groupId);
+    }
+
+    // Copies one student record; waits only for writers on the same stripe
+    bool getStudent(const string& email, Student& out) {
+        Student* student = db.findStudent(email);
+        if (!student) {
+            return false;
+        }
+
+        lock_guard<mutex> stripeLock(stripeOf(student).lock);
+        out = *student;
+        return true;
+    }
+
+    string groupName(uint32_t groupId) {
+        lock_guard<mutex> lock(statsMutex);
+        return db.groupName(groupId);
+    }
+
+    // Setup and reporting helpers; the ones reading group state take the stats mutex
+
+    int getStudentCount() {
+        return db.getStudentCount();
+    }
+
+    vector<string> getAllEmails() {
+        return db.getAllEmails();
+    }
+
+    vector<uint32_t> getAllGroupIds() {
+        lock_guard<mutex> lock(statsMutex);
+        return db.getAllGroupIds();
+    }
+
+    vector<GroupSummary> topGroupsByStudents(size_t k) {
+        lock_guard<mutex> lock(statsMutex);
+        return db.topGroupsByStudents(k);
+    }
+
+    vector<GroupSummary> topGroupsByRating(size_t k) {
+        lock_guard<mutex> lock(statsMutex);
+        return db.topGroupsByRating(k);
+    }
+};
+
+#endif // CONCURRENT_STUDENT_DB_H
@@ -0,0 +1,157 @@
+#ifndef DURABLE_STUDENT_DB_H
+#define DURABLE_STUDENT_DB_H
+
+#include <string>
+#include <unistd.h>
+#include "student_manager_o.h"
+#include "change_log.h"
+
+using namespace std;
+
+struct DurableOptions {
+    string snapshotFile = "students.snap";
+    string logFile = "students.wal";
+    size_t checkpointEvery = 1000000;  // logged changes between automatic checkpoints, 0 = manual only
+    ChangeLogOptions log;
+};
+
+// OptimizedStudentDB whose group changes survive restarts without rewriting the data:
+// the state on disk is the last snapshot plus the change log written since.
+// - changeGroupByEmail applies the change, appends it to the log and returns its log
+//   sequence number; the log's flusher makes it durable within log.syncInterval.
+//   waitDurable(lsn) waits for that one change, sync() for everything so far.
+// - checkpoint() writes a new snapshot and starts an empty log. A crash between the
+//   two only means replaying changes the snapshot already has, which is harmless
+//   because a change sets the group rather than adjusting it.
+// - Errors are returned, not only printed: a change the log cannot take (an email or
+//   group over kMaxChangeLogField bytes, or a failed log) is refused before it touches
+//   the data and returns 0. A failed automatic checkpoint is counted in
+//   failedCheckpoints() and retried after twice as many changes; once the log itself
+//   has failed, changes are refused until a checkpoint() succeeds.
+// Not thread-safe, like OptimizedStudentDB.
+class DurableStudentDB {
+private:
+    OptimizedStudentDB db;
+    ChangeLog log;
+    DurableOptions options;
+    size_t changesSinceCheckpoint = 0;
+    size_t checkpointThreshold;  // checkpointEvery, doubled after every failed checkpoint
+    size_t checkpointFailures = 0;
+    size_t replayed = 0;
+
+    static bool fitsLog(const string& email, const string& newGroup) {
+        return email.size() <= kMaxChangeLogField && newGroup.size() <= kMaxChangeLogField;
+    }
+
+    void checkpointIfDue() {
+        if (options.checkpointEvery == 0 || changesSinceCheckpoint < checkpointThreshold) {
+            return;
+        }
+        if (checkpoint()) {
+            checkpointThreshold = options.checkpointEvery;
+        } else {
+            checkpointFailures++;
+            checkpointThreshold = checkpointThreshold * 2;
+        }
+    }
+
+public:
+    explicit DurableStudentDB(const DurableOptions& durableOptions = {})
+        : options(durableOptions), checkpointThreshold(durableOptions.checkpointEvery) {}
+
+    // Loads the snapshot, or csvFile when there is no snapshot yet, then replays the log.
+    // Without a snapshot the recovered state is checkpointed right away.
+    bool open(const string& csvFile) {
+        bool hasSnapshot = access(options.snapshotFile.c_str(), F_OK) == 0;
+        LoadStats stats = hasSnapshot ? db.loadFromSnapshot(options.snapshotFile)
+                                      : db.loadFromCSVParallel(csvFile);
+        if (stats.rows == 0) {
+            return false;
+        }
+
+        size_t validBytes = replayChangeLog(options.logFile, [&](string_view email, string_view group) {
+            db.changeGroupByEmail(string(email), string(group));
+        }, replayed);
+        changesSinceCheckpoint = replayed;
+
+        if (!hasSnapshot) {
+            return checkpoint();
+        }
+        return log.open(options.logFile, validBytes, options.log);
+    }
+
+    // Op2, logged. Returns the change's sequence number, or 0 if the email is unknown or
+    // the change cannot be logged (then nothing changes). The change is durable after
+    // the next group commit, see waitDurable.
+    uint64_t changeGroupByEmail(const string& email, const string& newGroup) {
+        if (!fitsLog(email, newGroup) || !log.accepting() || !db.changeGroupByEmail(email, newGroup)) {
+            return 0;
+        }
+        uint64_t lsn = log.append(email, newGroup);
+        changesSinceCheckpoint++;
+        checkpointIfDue();
+        return lsn;
+    }
+
+    // Batched Op2 (see OptimizedStudentDB::changeGroupsByEmail). Every pair is logged;
+    // replaying one whose email is unknown is a no-op, as it was here. If any pair
+    // cannot be logged, the whole batch is refused and 0 is returned.
+    size_t changeGroupsByEmail(const vector<pair<string, string>>& changes) {
+        if (!log.accepting()) {
+            return 0;
+        }
+        for (const auto& change : changes) {
+            if (!fitsLog(change.first, change.second)) {
+                return 0;
+            }
+        }
+        size_t found = db.changeGroupsByEmail(changes);
+        for (const auto& change : changes) {
+            log.append(change.first, change.second);
+        }
+        changesSinceCheckpoint += changes.size();
+        checkpointIfDue();
+        return found;
+    }
+
+    // Blocks until change `lsn` is on disk; false if the log failed before that
+    bool waitDurable(uint64_t lsn) {
+        return log.waitDurable(lsn);
+    }
+
+    // Blocks until every change so far is on disk
+    bool sync() {
+        return log.sync();
+    }
+
+    // New snapshot of the current state, then an empty log. O(n), so run it rarely.
+    bool checkpoint() {
+        log.sync();
+        if (!db.saveSnapshot(options.snapshotFile)) {
+            cerr << "Error writing snapshot " << options.snapshotFile << endl;
+            return false;
+        }
+        changesSinceCheckpoint = 0;
+        return log.open(options.logFile, 0, options.log);
+    }
+
+    const OptimizedStudentDB& database() const {
+        return db;
+    }
+
+    // Automatic checkpoints that failed since open()
+    size_t failedCheckpoints() const {
+        return checkpointFailures;
+    }
+
+    // Changes applied from the log by the last open()
+    size_t replayedChanges() const {
+        return replayed;
+    }
+
+    ChangeLogStats logStats() {
+        return log.getStats();
+    }
+};
+
+#endif // DURABLE_STUDENT_DB_H
@@ -0,0 +1,130 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Every thread that touches an EpochDomain gets a small, process-wide slot number.
+// Slots are recycled when threads exit.
+class ThreadSlots {
+public:
+    static constexpr size_t kMaxThreads = 256;
+
+    static size_t current() {
+        thread_local Holder holder;
+        return holder.slot;
+    }
+
+private:
+    struct Holder {
+        size_t slot;
+        Holder() : slot(acquire()) {}
+        ~Holder() { release(slot); }
+    };
+
+    static atomic<bool>* taken() {
+        static atomic<bool> slots[kMaxThreads] = {};
+        return slots;
+    }
+
+    static size_t acquire() {
+        for (size_t i = 0; i < kMaxThreads; i++) {
+            bool expected = false;
+            if (taken()[i].compare_exchange_strong(expected, true)) {
+                return i;
+            }
+        }
+        throw runtime_error("Too many threads for EpochDomain");
+    }
+
+    static void release(size_t slot) {
+        taken()[slot].store(false, memory_order_release);
+    }
+};
+
+// Epoch-based reclamation for RCU-style publishing. Readers pin the current epoch
+// while they dereference a published pointer; they never take a lock. Writers swap
+// the pointer and retire the old object, which is freed once every reader that
+// could still see it has unpinned.
+class EpochDomain {
+private:
+    struct alignas(64) ReaderEpoch {
+        atomic<uint64_t> epoch{0};  // 0 = not reading
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        function<void()> destroy;
+    };
+
+    atomic<uint64_t> globalEpoch{1};
+    ReaderEpoch readers[ThreadSlots::kMaxThreads];
+    mutex retiredMutex;
+    vector<Retired> retired;
+
+    uint64_t oldestPinnedEpoch() const {
+        uint64_t oldest = UINT64_MAX;
+        for (const auto& reader : readers) {
+            uint64_t epoch = reader.epoch.load(memory_order_acquire);
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+public:
+    class Guard {
+    private:
+        atomic<uint64_t>* slot;
+
+    public:
+        explicit Guard(atomic<uint64_t>* s) : slot(s) {}
+        ~Guard() { slot->store(0, memory_order_release); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    ~EpochDomain() {
+        for (auto& item : retired) {
+            item.destroy();
+        }
+    }
+
+    // Not reentrant: one Guard per thread at a time
+    Guard pin() {
+        atomic<uint64_t>& slot = readers[ThreadSlots::current()].epoch;
+        slot.store(globalEpoch.load(memory_order_acquire), memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        return Guard(&slot);
+    }
+
+    // Call after the object has been unlinked from every published pointer
+    template <class T>
+    void retire(T* object) {
+        uint64_t epoch = globalEpoch.fetch_add(1, memory_order_acq_rel);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        lock_guard<mutex> lock(retiredMutex);
+        retired.push_back({epoch, [object]() { delete object; }});
+
+        uint64_t oldest = oldestPinnedEpoch();
+        size_t kept = 0;
+        for (auto& item : retired) {
+            if (item.epoch < oldest) {
+                item.destroy();
+            } else {
+                retired[kept++] = move(item);
+            }
+        }
+        retired.resize(kept);
+    }
+};
+
+#endif // EPOCH_H
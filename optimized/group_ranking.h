@@ -0,0 +1,100 @@
+#ifndef GROUP_RANKING_H
+#define GROUP_RANKING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+
+using namespace std;
+
+// Keeps group ids ordered by score, best first (ties: lower id first).
+// Backed by an order-statistic red-black tree, so update/remove are O(log G)
+// and the best group is at begin().
+template <class Score>
+class GroupRanking {
+private:
+    struct Entry {
+        Score score;
+        uint32_t id;
+    };
+
+    struct Better {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.score != b.score) return a.score > b.score;
+            return a.id < b.id;
+        }
+    };
+
+    using Tree = __gnu_pbds::tree<Entry, __gnu_pbds::null_type, Better, __gnu_pbds::rb_tree_tag,
+                                  __gnu_pbds::tree_order_statistics_node_update>;
+
+    Tree entries;
+    vector<Score> scores;   // score each id was inserted with, needed to find it again
+    vector<bool> ranked;
+
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    void update(uint32_t id, Score score) {
+        if (id >= scores.size()) {
+            scores.resize(id + 1);
+            ranked.resize(id + 1, false);
+        }
+        if (ranked[id]) {
+            if (scores[id] == score) return;
+            entries.erase(Entry{scores[id], id});
+        }
+        entries.insert(Entry{score, id});
+        scores[id] = score;
+        ranked[id] = true;
+    }
+
+    void remove(uint32_t id) {
+        if (id < ranked.size() && ranked[id]) {
+            entries.erase(Entry{scores[id], id});
+            ranked[id] = false;
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        scores.clear();
+        ranked.clear();
+    }
+
+    uint32_t top() const {
+        return entries.empty() ? kNone : entries.begin()->id;
+    }
+
+    // The k best groups with their scores, O(k + log G)
+    vector<pair<uint32_t, Score>> top(size_t k) const {
+        vector<pair<uint32_t, Score>> result;
+        result.reserve(min(k, entries.size()));
+        for (auto it = entries.begin(); it != entries.end() && result.size() < k; ++it) {
+            result.push_back({it->id, it->score});
+        }
+        return result;
+    }
+
+    // 0-based position of a group (0 = best), or kNone if it is not ranked, O(log G)
+    size_t rankOf(uint32_t id) const {
+        if (id >= ranked.size() || !ranked[id]) return kNone;
+        return entries.order_of_key(Entry{scores[id], id});
+    }
+
+    // Group at a 0-based position, or kNone past the end, O(log G)
+    uint32_t at(size_t rank) const {
+        auto it = entries.find_by_order(rank);
+        return it == entries.end() ? kNone : it->id;
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+};
+
+#endif // GROUP_RANKING_H
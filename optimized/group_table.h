@@ -0,0 +1,44 @@
+#ifndef GROUP_TABLE_H
+#define GROUP_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Interns group names as dense ids, in order of first appearance
+class GroupTable {
+private:
+    unordered_map<string, uint32_t> idsByName;
+    vector<string> names;
+
+public:
+    static constexpr uint32_t kNoGroup = UINT32_MAX;
+
+    uint32_t intern(string_view name) {
+        auto inserted = idsByName.try_emplace(string(name), static_cast<uint32_t>(names.size()));
+        if (inserted.second) {
+            names.push_back(inserted.first->first);
+        }
+        return inserted.first->second;
+    }
+
+    uint32_t find(const string& name) const {
+        auto it = idsByName.find(name);
+        return it == idsByName.end() ? kNoGroup : it->second;
+    }
+
+    const string& name(uint32_t id) const {
+        static const string empty;
+        return id < names.size() ? names[id] : empty;
+    }
+
+    size_t size() const {
+        return names.size();
+    }
+};
+
+#endif // GROUP_TABLE_H
@@ -0,0 +1,183 @@
+#include "concurrent_student_db.h"
+#include "sharded_student_db.h"
+#include "../common/workload.h"
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <sstream>
+
+using namespace std;
+using namespace chrono;
+
+struct ThreadResult {
+    long long op1Count = 0;
+    long long op2Count = 0;
+    long long op3Count = 0;
+};
+
+vector<unsigned> parseList(const string& list) {
+    vector<unsigned> values;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(stoi(item));
+    }
+    return values;
+}
+
+// Runs the workload on `threads` threads for `secondsPerRun`, returns ops/sec.
+// Thread t draws its ops from seed + t, so runs are repeatable.
+template <class DB>
+double runMix(DB& db, const vector<string>& emails, const vector<uint32_t>& groups, const WorkloadSpec& spec,
+              uint64_t seed, unsigned threads, int secondsPerRun, ThreadResult& total) {
+    vector<ThreadResult> results(threads);
+    vector<thread> workers;
+    atomic<bool> start{false};
+    auto endTime = steady_clock::now();
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            WorkloadGenerator generator(spec, emails.size(), groups.size(), seed + t);
+            ThreadResult& result = results[t];
+
+            while (!start.load(memory_order_acquire)) {
+                this_thread::yield();
+            }
+
+            while (steady_clock::now() < endTime) {
+                WorkloadOp op = generator.next();
+
+                if (op.type == kOpMostStudents) {
+                    db.findGroupWithMostStudents();
+                    result.op1Count++;
+                } else if (op.type == kOpChangeGroup) {
+                    db.changeGroupByEmail(emails[op.email], groups[op.group]);
+                    result.op2Count++;
+                } else {
+                    db.findGroupWithHighestRating();
+                    result.op3Count++;
+                }
+            }
+        });
+    }
+
+    auto startTime = steady_clock::now();
+    endTime = startTime + seconds(secondsPerRun);
+    start.store(true, memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto duration = duration_cast<milliseconds>(steady_clock::now() - startTime).count();
+
+    total = ThreadResult();
+    for (const auto& result : results) {
+        total.op1Count += result.op1Count;
+        total.op2Count += result.op2Count;
+        total.op3Count += result.op3Count;
+    }
+    long long totalOps = total.op1Count + total.op2Count + total.op3Count;
+    return duration > 0 ? totalOps * 1000.0 / duration : 0.0;
+}
+
+template <class DB>
+void sweepThreads(DB& db, const string& label, const WorkloadSpec& spec, uint64_t seed,
+                  const vector<unsigned>& threadCounts, int secondsPerRun) {
+    // Sorted, so an email index means the same student for every backend and shard count
+    vector<string> emails = db.getAllEmails();
+    sort(emails.begin(), emails.end());
+    vector<uint32_t> groups = db.getAllGroupIds();
+
+    if (emails.empty() || groups.empty()) {
+        cerr << "No data loaded!" << endl;
+        return;
+    }
+
+    double baseline = 0.0;
+    for (unsigned threads : threadCounts) {
+        ThreadResult total;
+        double opsPerSecond = runMix(db, emails, groups, spec, seed, threads, secondsPerRun, total);
+        if (baseline == 0.0) baseline = opsPerSecond;
+
+        cout << label << " | Threads: " << threads
+             << " | Operations per second: " << fixed << setprecision(0) << opsPerSecond
+             << " | Speedup: " << setprecision(2) << opsPerSecond / baseline << "x"
+             << " | Op1:Op2:Op3 = " << total.op1Count << ":" << total.op2Count << ":" << total.op3Count
+             << endl;
+    }
+
+    cout << label << " | Group with most students: " << db.findGroupWithMostStudents() << endl;
+    cout << label << " | Group with highest rating: " << db.findGroupWithHighestRating() << endl << endl;
+}
+
+// Usage: ./main [--dataset students.csv] [--mode concurrent|sharded|both] [--threads 1,2,4,8]
+//               [--shards 1,4,16] [--seconds 3] [--mix 5:1:100] [--seed 42] [--email-skew 0] [--group-skew 0]
+int main(int argc, char* argv[]) {
+    string dataset = "students.csv";
+    string mode = "both";
+    WorkloadSpec spec;
+    uint64_t seed = 42;
+    vector<unsigned> threadCounts;
+    vector<unsigned> shardCounts = {1, 4, 16, 64};
+    int secondsPerRun = 3;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--dataset") {
+            dataset = argv[i + 1];
+        } else if (arg == "--mode") {
+            mode = argv[i + 1];
+        } else if (arg == "--threads") {
+            threadCounts = parseList(argv[i + 1]);
+        } else if (arg == "--shards") {
+            shardCounts = parseList(argv[i + 1]);
+        } else if (arg == "--seconds") {
+            secondsPerRun = stoi(argv[i + 1]);
+        } else if (arg == "--seed") {
+            seed = stoull(argv[i + 1]);
+        } else if (arg == "--mix") {
+            parseMix(argv[i + 1], spec);
+        } else if (arg == "--email-skew") {
+            spec.emailSkew = parseSkew(argv[i + 1]);
+        } else if (arg == "--group-skew") {
+            spec.groupSkew = parseSkew(argv[i + 1]);
+        }
+    }
+    if (secondsPerRun <= 0) {
+        cerr << "--seconds must be a whole number of seconds > 0" << endl;
+        return 1;
+    }
+    if (threadCounts.empty()) {
+        for (unsigned t = 1; t <= defaultThreadCount(); t *= 2) {
+            threadCounts.push_back(t);
+        }
+        if (threadCounts.back() != defaultThreadCount()) {
+            threadCounts.push_back(defaultThreadCount());
+        }
+    }
+
+    cout << "Starting concurrent benchmark (" << secondsPerRun << " seconds per run)..." << endl;
+    cout << "Operation ratio - Op1:Op2:Op3 = " << spec.mix[0] << ":" << spec.mix[1] << ":" << spec.mix[2]
+         << ", Zipf skew - emails: " << spec.emailSkew
+         << ", groups: " << spec.groupSkew << ", seed " << seed << endl << endl;
+
+    if (mode == "concurrent" || mode == "both") {
+        ConcurrentStudentDB db;
+        db.loadFromCSV(dataset);
+        cout << "Loaded " << db.getStudentCount() << " students" << endl;
+        sweepThreads(db, "Concurrent", spec, seed, threadCounts, secondsPerRun);
+    }
+
+    if (mode == "sharded" || mode == "both") {
+        for (unsigned shards : shardCounts) {
+            ShardedStudentDB db(shards);
+            db.loadFromCSV(dataset);
+            cout << "Loaded " << db.getStudentCount() << " students into " << shards << " shards" << endl;
+            sweepThreads(db, "Sharded x" + to_string(shards), spec, seed, threadCounts, secondsPerRun);
+        }
+    }
+
+    return 0;
+}
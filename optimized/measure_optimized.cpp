@@ -1,83 +1,96 @@
 #include "student_manager_o.h"
-#include <iostream>
-#include <chrono>
-#include <random>
+#include "../common/benchmark.h"
 #include <iomanip>
 
-using namespace std;
 using namespace chrono;
 
-int main() {
+class OptimizedBackend {
+public:
     OptimizedStudentDB db;
+    vector<string> emails;
+    vector<uint32_t> groups;
+
+    static constexpr const char* kName = "Optimized";
+    static constexpr const char* kDescription = "with cached group rankings";
+
+    bool load(const string& dataset) {
+        LoadStats stats = db.loadFromCSVParallel(dataset);
+        cout << "Parsed " << stats.rows << " rows at " << fixed << setprecision(0) << stats.rowsPerSecond()
+             << " rows/sec, " << setprecision(1) << stats.megabytesPerSecond() << " MB/s" << endl;
+        emails = db.getAllEmails();
+        groups = db.getAllGroupIds();
+        sortKeys(emails);
+        sortKeys(groups, [&](uint32_t a, uint32_t b) { return db.groupName(a) < db.groupName(b); });
+        return db.getStudentCount() > 0;
+    }
 
-    cout << "Loading students from CSV..." << endl;
-    db.loadFromCSV("students.csv");
-    cout << "Loaded " << db.getStudentCount() << " students" << endl << endl;
+    size_t size() const { return db.getStudentCount(); }
+    size_t emailCount() const { return emails.size(); }
+    size_t groupCount() const { return groups.size(); }
 
-    vector<string> emails = db.getAllEmails();
-    vector<string> groups = db.getAllGroups();
+    void mostStudents() {
+        db.findGroupWithMostStudents();
+    }
 
-    if (emails.empty() || groups.empty()) {
-        cerr << "No data loaded!" << endl;
-        return 1;
+    void changeGroup(size_t email, size_t group) {
+        db.changeGroupByEmail(emails[email], groups[group]);
     }
 
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> emailDist(0, emails.size() - 1);
-    uniform_int_distribution<> groupDist(0, groups.size() - 1);
-    uniform_int_distribution<> opDist(1, 106);
-
-    cout << "Starting benchmark (10 seconds)..." << endl;
-    cout << "Operation ratio - Op1:Op2:Op3 = 5:1:100" << endl << endl;
-
-    int op1Count = 0, op2Count = 0, op3Count = 0;
-    int totalOps = 0;
-
-    auto startTime = high_resolution_clock::now();
-    auto endTime = startTime + seconds(10);
-
-    while (high_resolution_clock::now() < endTime) {
-        int opType = opDist(gen);
-
-        if (opType <= 5) {
-            db.findGroupWithMostStudents();
-            op1Count++;
-        } else if (opType == 6) {
-            string email = emails[emailDist(gen)];
-            string newGroup = groups[groupDist(gen)];
-            db.changeGroupByEmail(email, newGroup);
-            op2Count++;
-        } else {
-            db.findGroupWithHighestRating();
-            op3Count++;
-        }
-
-        totalOps++;
+    void highestRating() {
+        db.findGroupWithHighestRating();
     }
 
-    auto actualEndTime = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(actualEndTime - startTime).count();
+    string mostStudentsGroup() {
+        return db.findGroupWithMostStudents();
+    }
+
+    string highestRatingGroup() {
+        return db.findGroupWithHighestRating();
+    }
 
-    cout << "=== BENCHMARK RESULTS ===" << endl;
-    cout << "Duration: " << duration << " ms" << endl;
-    cout << "Total operations: " << totalOps << endl;
-    cout << "Operations per second: " << (totalOps * 1000.0 / duration) << endl << endl;
+    bool lookup(size_t email) {
+        return db.findStudent(emails[email]) != nullptr;
+    }
+};
+
+// Extras on the state the op mix left, before the driver's counter passes
+void printExtras(OptimizedBackend& backend) {
+    OptimizedStudentDB& db = backend.db;
+    cout << "\nTop 3 groups by students:" << endl;
+    for (const auto& group : db.topGroupsByStudents(3)) {
+        cout << "  " << group.name << ": " << group.studentCount << " students" << endl;
+    }
+    cout << "Top 3 groups by average rating:" << endl;
+    for (const auto& group : db.topGroupsByRating(3)) {
+        cout << "  " << group.name << ": " << fixed << setprecision(2) << group.averageRating << endl;
+    }
 
-    cout << "Operation 1 (Find group with most students): " << op1Count << endl;
-    cout << "Operation 2 (Change student group): " << op2Count << endl;
-    cout << "Operation 3 (Find group with highest rating): " << op3Count << endl << endl;
+    // Nightly re-grouping: the same number of Op2 calls, one by one and as one batch
+    const size_t batchSize = 200000;
+    mt19937_64 gen(1);
+    uniform_int_distribution<size_t> emailDist(0, backend.emails.size() - 1);
+    uniform_int_distribution<size_t> groupDist(0, backend.groups.size() - 1);
+    vector<pair<string, uint32_t>> single, batch;
+    for (size_t i = 0; i < batchSize; i++) {
+        single.emplace_back(backend.emails[emailDist(gen)], backend.groups[groupDist(gen)]);
+        batch.emplace_back(backend.emails[emailDist(gen)], backend.groups[groupDist(gen)]);
+    }
 
-    cout << "Actual ratio: " << op1Count << ":" << op2Count << ":" << op3Count << endl;
+    auto singleStart = high_resolution_clock::now();
+    for (const auto& change : single) {
+        db.changeGroupByEmail(change.first, change.second);
+    }
+    double singleSeconds = chrono::duration<double>(high_resolution_clock::now() - singleStart).count();
 
-    double ratio1 = (double)op1Count / op2Count;
-    double ratio3 = (double)op3Count / op2Count;
-    cout << "Normalized ratio: " << fixed << setprecision(1)
-         << ratio1 << ":1:" << ratio3 << endl;
+    auto batchStart = high_resolution_clock::now();
+    db.changeGroupsByEmail(batch);
+    double batchSeconds = chrono::duration<double>(high_resolution_clock::now() - batchStart).count();
 
-    cout << "\n=== VERIFICATION ===" << endl;
-    cout << "Group with most students: " << db.findGroupWithMostStudents() << endl;
-    cout << "Group with highest rating: " << db.findGroupWithHighestRating() << endl;
+    cout << "\nOp2 one by one: " << setprecision(0) << batchSize / singleSeconds << " changes/sec" << endl;
+    cout << "Op2 batched: " << batchSize / batchSeconds << " changes/sec" << endl;
+}
 
-    return 0;
-}
\ No newline at end of file
+int main(int argc, char* argv[]) {
+    OptimizedBackend backend;
+    return benchmarkMain(backend, argc, argv, printExtras);
+}
@@ -0,0 +1,384 @@
+#ifndef SHARDED_STUDENT_DB_H
+#define SHARDED_STUDENT_DB_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "student_manager_o.h"
+#include "concurrent_student_db.h"
+#include "epoch.h"
+
+using namespace std;
+
+// OptimizedStudentDB split into N independent shards by email hash.
+// - Op2 locks exactly one shard and updates that shard's partial GroupStats,
+//   so writers on different shards never touch shared state except one counter.
+// - Op1/Op3 merge lazily: only groups that some shard marked dirty since the last
+//   merge are re-summed and re-ranked (O(dirty * log G)), then the winners are
+//   published as an epoch-protected snapshot like in ConcurrentStudentDB.
+// - If another thread is already merging, a reader returns the previous snapshot
+//   instead of waiting, so answers may trail in-flight writes by one merge.
+class ShardedStudentDB {
+private:
+    struct alignas(64) Shard {
+        mutex lock;
+        vector<Student> students;
+        FlatEmailIndex emailIndex;
+        vector<GroupStats> partialStats;   // this shard's students only, by group id
+        vector<GroupStats> mergedStats;    // partialStats as of the last merge
+        vector<uint32_t> dirtyGroups;
+        vector<bool> isDirty;
+        atomic<bool> hasDirty{false};      // lets the merger skip clean shards without locking
+
+        GroupStats& partial(uint32_t groupId) {
+            if (groupId >= partialStats.size()) {
+                partialStats.resize(groupId + 1);
+                mergedStats.resize(groupId + 1);
+                isDirty.resize(groupId + 1, false);
+            }
+            return partialStats[groupId];
+        }
+
+        Student* find(const string& email) {
+            uint32_t index = emailIndex.find(email, students);
+            return index == FlatEmailIndex::kNotFound ? nullptr : &students[index];
+        }
+
+        void markDirty(uint32_t groupId) {
+            if (!isDirty[groupId]) {
+                isDirty[groupId] = true;
+                dirtyGroups.push_back(groupId);
+                hasDirty.store(true, memory_order_relaxed);
+            }
+        }
+    };
+
+    vector<unique_ptr<Shard>> shards;
+
+    mutex groupsMutex;
+    GroupTable groups;
+    atomic<uint32_t> groupCount{0};    // groups.size(), for checking ids without groupsMutex
+
+    mutex mergeMutex;
+    vector<GroupStats> groupStats;     // merged over all shards
+    GroupRanking<int> groupsByCount;
+    GroupRanking<double> groupsByRating;
+    vector<uint32_t> touched;
+
+    atomic<uint64_t> writes{0};
+    atomic<uint64_t> mergedWrites{0};
+
+    EpochDomain epochs;
+    atomic<const TopGroupsSnapshot*> snapshot{nullptr};
+
+    Shard& shardOf(const string& email) {
+        return *shards[hash<string_view>()(email) % shards.size()];
+    }
+
+    // Caller holds mergeMutex
+    void mergeDirtyGroups() {
+        uint64_t seenWrites = writes.load(memory_order_acquire);
+        touched.clear();
+
+        for (auto& shard : shards) {
+            if (!shard->hasDirty.load(memory_order_relaxed)) continue;
+
+            lock_guard<mutex> lock(shard->lock);
+            for (uint32_t id : shard->dirtyGroups) {
+                if (id >= groupStats.size()) {
+                    groupStats.resize(id + 1);
+                }
+                GroupStats& merged = shard->mergedStats[id];
+                const GroupStats& current = shard->partialStats[id];
+                groupStats[id].studentCount += current.studentCount - merged.studentCount;
+                groupStats[id].totalRating += current.totalRating - merged.totalRating;
+                merged = current;
+                shard->isDirty[id] = false;
+                touched.push_back(id);
+            }
+            shard->dirtyGroups.clear();
+            shard->hasDirty.store(false, memory_order_relaxed);
+        }
+
+        for (uint32_t id : touched) {
+            const GroupStats& stats = groupStats[id];
+            if (stats.studentCount > 0) {
+                groupsByCount.update(id, stats.studentCount);
+                groupsByRating.update(id, stats.getAverageRating());
+            } else {
+                groupsByCount.remove(id);
+                groupsByRating.remove(id);
+            }
+        }
+
+        publish();
+        mergedWrites.store(seenWrites, memory_order_release);
+    }
+
+    // Caller holds mergeMutex
+    void publish() {
+        const TopGroupsSnapshot* current = snapshot.load(memory_order_relaxed);
+        string maxCountGroup, maxRatingGroup;
+        {
+            lock_guard<mutex> lock(groupsMutex);
+            maxCountGroup = groups.name(groupsByCount.top());
+            maxRatingGroup = groups.name(groupsByRating.top());
+        }
+
+        if (current && current->maxCountGroup == maxCountGroup &&
+            current->maxRatingGroup == maxRatingGroup) {
+            return;
+        }
+
+        auto* next = new TopGroupsSnapshot{move(maxCountGroup), move(maxRatingGroup),
+                                           current ? current->version + 1 : 1};
+        snapshot.store(next, memory_order_release);
+        if (current) {
+            epochs.retire(current);
+        }
+    }
+
+    void mergeIfNeeded() {
+        if (writes.load(memory_order_acquire) == mergedWrites.load(memory_order_acquire)) {
+            return;
+        }
+        unique_lock<mutex> lock(mergeMutex, try_to_lock);
+        if (lock.owns_lock()) {
+            mergeDirtyGroups();
+        }
+    }
+
+    const TopGroupsSnapshot* currentSnapshot() {
+        return snapshot.load(memory_order_acquire);
+    }
+
+public:
+    explicit ShardedStudentDB(size_t shardCount = 16) {
+        if (shardCount == 0) shardCount = 1;
+        for (size_t i = 0; i < shardCount; i++) {
+            shards.push_back(make_unique<Shard>());
+        }
+    }
+
+    ShardedStudentDB(const ShardedStudentDB&) = delete;
+    ShardedStudentDB& operator=(const ShardedStudentDB&) = delete;
+
+    ~ShardedStudentDB() {
+        delete snapshot.load();
+    }
+
+    size_t shardCount() const {
+        return shards.size();
+    }
+
+    // Not thread-safe: load before sharing the object between threads.
+    // Rows are parsed on all cores, then every worker fills its own subset of shards.
+    LoadStats loadFromCSV(const string& filename, unsigned threads = 0) {
+        struct ParsedRow {
+            Student student;
+            string group;
+            size_t shard;
+        };
+
+        LoadStats stats;
+        auto startTime = chrono::steady_clock::now();
+
+        MappedFile file(filename);
+        if (!file.isOpen()) {
+            cerr << "Error opening file!" << endl;
+            return stats;
+        }
+        if (threads == 0) threads = defaultThreadCount();
+
+        size_t shardTotal = shards.size();
+        vector<vector<ParsedRow>> chunks = parseCSVParallel<ParsedRow>(file, threads, [&](const StudentRow& row) {
+            size_t shard = hash<string_view>()(row.email) % shardTotal;
+            return ParsedRow{makeStudent(row, GroupTable::kNoGroup), string(row.group), shard};
+        });
+
+        // Interning in file order keeps ids identical to OptimizedStudentDB
+        for (auto& chunk : chunks) {
+            for (auto& row : chunk) {
+                row.student.m_groupId = groups.intern(row.group);
+            }
+            stats.rows += chunk.size();
+        }
+        groupCount.store(uint32_t(groups.size()), memory_order_release);
+
+        // Worker t owns the shards with index % workerCount == t and walks the rows in file order
+        size_t workerCount = min<size_t>(threads, shardTotal);
+        vector<thread> workers;
+        for (size_t t = 0; t < workerCount; t++) {
+            workers.emplace_back([&, t]() {
+                for (auto& chunk : chunks) {
+                    for (auto& row : chunk) {
+                        if (row.shard % workerCount != t) continue;
+                        Shard& shard = *shards[row.shard];
+
+                        uint32_t hash = FlatEmailIndex::hashEmail(row.student.m_email);
+                        uint32_t index = shard.emailIndex.find(row.student.m_email, hash, shard.students);
+                        if (index == FlatEmailIndex::kNotFound) {
+                            index = shard.students.size();
+                            shard.emailIndex.insert(hash, index);
+                            shard.students.emplace_back();
+                        } else {
+                            const Student& old = shard.students[index];
+                            GroupStats& oldGroup = shard.partial(old.m_groupId);
+                            oldGroup.studentCount--;
+                            oldGroup.totalRating -= old.m_rating;
+                            shard.markDirty(old.m_groupId);
+                        }
+                        Student& student = shard.students[index];
+                        student = move(row.student);
+
+                        GroupStats& group = shard.partial(student.m_groupId);
+                        group.studentCount++;
+                        group.totalRating += student.m_rating;
+                        shard.markDirty(student.m_groupId);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        {
+            lock_guard<mutex> lock(mergeMutex);
+            mergeDirtyGroups();
+        }
+
+        stats.bytes = file.size();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return stats;
+    }
+
+    string findGroupWithMostStudents() {
+        mergeIfNeeded();
+        auto guard = epochs.pin();
+        const TopGroupsSnapshot* current = currentSnapshot();
+        return current ? current->maxCountGroup : string();
+    }
+
+    string findGroupWithHighestRating() {
+        mergeIfNeeded();
+        auto guard = epochs.pin();
+        const TopGroupsSnapshot* current = currentSnapshot();
+        return current ? current->maxRatingGroup : string();
+    }
+
+    // False for unknown emails and for group ids that were never interned
+    bool changeGroupByEmail(const string& email, uint32_t newGroupId) {
+        if (newGroupId >= groupCount.load(memory_order_acquire)) {
+            return false;
+        }
+        Shard& shard = shardOf(email);
+        {
+            lock_guard<mutex> lock(shard.lock);
+            Student* found = shard.find(email);
+            if (!found) {
+                return false;
+            }
+
+            Student& student = *found;
+            if (student.m_groupId == newGroupId) {
+                return true;
+            }
+
+            GroupStats& oldGroup = shard.partial(student.m_groupId);
+            oldGroup.studentCount--;
+            oldGroup.totalRating -= student.m_rating;
+            shard.markDirty(student.m_groupId);
+
+            student.m_groupId = newGroupId;
+
+            GroupStats& newGroup = shard.partial(newGroupId);
+            newGroup.studentCount++;
+            newGroup.totalRating += student.m_rating;
+            shard.markDirty(newGroupId);
+        }
+        writes.fetch_add(1, memory_order_release);
+        return true;
+    }
+
+    bool changeGroupByEmail(const string& email, const string& newGroup) {
+        uint32_t groupId;
+        {
+            lock_guard<mutex> lock(groupsMutex);
+            groupId = groups.intern(newGroup);
+            groupCount.store(uint32_t(groups.size()), memory_order_release);
+        }
+        return changeGroupByEmail(email, groupId);
+    }
+
+    // Forces a full merge, e.g. before reading a final answer
+    void flush() {
+        lock_guard<mutex> lock(mergeMutex);
+        mergeDirtyGroups();
+    }
+
+    int getStudentCount() {
+        size_t total = 0;
+        for (auto& shard : shards) {
+            lock_guard<mutex> lock(shard->lock);
+            total += shard->students.size();
+        }
+        return total;
+    }
+
+    vector<string> getAllEmails() {
+        vector<string> emails;
+        for (auto& shard : shards) {
+            lock_guard<mutex> lock(shard->lock);
+            for (const auto& student : shard->students) {
+                emails.push_back(student.m_email);
+            }
+        }
+        return emails;
+    }
+
+    vector<uint32_t> getAllGroupIds() {
+        lock_guard<mutex> lock(mergeMutex);
+        mergeDirtyGroups();
+        vector<uint32_t> ids;
+        for (uint32_t id = 0; id < groupStats.size(); id++) {
+            if (groupStats[id].studentCount > 0) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+
+    vector<GroupSummary> topGroupsByStudents(size_t k) {
+        lock_guard<mutex> lock(mergeMutex);
+        mergeDirtyGroups();
+        return summarize(groupsByCount.top(k));
+    }
+
+    vector<GroupSummary> topGroupsByRating(size_t k) {
+        lock_guard<mutex> lock(mergeMutex);
+        mergeDirtyGroups();
+        return summarize(groupsByRating.top(k));
+    }
+
+private:
+    // Caller holds mergeMutex
+    template <class Score>
+    vector<GroupSummary> summarize(const vector<pair<uint32_t, Score>>& entries) {
+        lock_guard<mutex> lock(groupsMutex);
+        vector<GroupSummary> result;
+        for (const auto& entry : entries) {
+            const GroupStats& stats = groupStats[entry.first];
+            result.push_back({entry.first, groups.name(entry.first), stats.studentCount, stats.getAverageRating()});
+        }
+        return result;
+    }
+};
+
+#endif // SHARDED_STUDENT_DB_H
@@ -0,0 +1,45 @@
+#include "student_manager_o.h"
+#include <iomanip>
+
+void printLoad(const string& label, const LoadStats& stats) {
+    cout << label << ": " << fixed << setprecision(1) << stats.seconds * 1000.0 << " ms ("
+         << setprecision(0) << stats.rowsPerSecond() << " rows/sec, "
+         << setprecision(1) << stats.bytes / (1024.0 * 1024.0) << " MB)" << endl;
+}
+
+// Usage: ./snapshot [students.csv] [students.snap]
+// Converts the CSV into a binary snapshot and compares the two startup paths.
+int main(int argc, char* argv[]) {
+    string csvFile = argc > 1 ? argv[1] : "students.csv";
+    string snapshotFile = argc > 2 ? argv[2] : "students.snap";
+
+    OptimizedStudentDB fromCSV;
+    printLoad("CSV load", fromCSV.loadFromCSVParallel(csvFile));
+    if (fromCSV.getStudentCount() == 0) {
+        cerr << "No data loaded!" << endl;
+        return 1;
+    }
+
+    if (!fromCSV.saveSnapshot(snapshotFile)) {
+        cerr << "Error writing " << snapshotFile << endl;
+        return 1;
+    }
+
+    OptimizedStudentDB fromSnapshot;
+    printLoad("Snapshot load", fromSnapshot.loadFromSnapshot(snapshotFile));
+
+    bool same = fromSnapshot.getStudentCount() == fromCSV.getStudentCount() &&
+                fromSnapshot.findGroupWithMostStudents() == fromCSV.findGroupWithMostStudents() &&
+                fromSnapshot.findGroupWithHighestRating() == fromCSV.findGroupWithHighestRating();
+    for (const string& email : fromCSV.getAllEmails()) {
+        if (!same) break;
+        const Student* a = fromCSV.findStudent(email);
+        const Student* b = fromSnapshot.findStudent(email);
+        same = b && a->m_name == b->m_name && a->m_phone_number == b->m_phone_number &&
+               a->m_rating == b->m_rating && a->m_birth_day == b->m_birth_day &&
+               fromCSV.groupName(a->m_groupId) == fromSnapshot.groupName(b->m_groupId);
+    }
+    cout << "Students: " << fromSnapshot.getStudentCount() << " | "
+         << (same ? "identical" : "different") << endl;
+    return same ? 0 : 1;
+}
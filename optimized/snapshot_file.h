@@ -0,0 +1,248 @@
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../common/flat_email_index.h"
+#include "../common/mapped_csv.h"
+
+using namespace std;
+
+// Binary snapshot of a student database. Layout (native little-endian):
+//   SnapshotHeader | section 0 | section 1 | ... | string pool
+// Every section is one fixed-width column with one entry per student (or per group),
+// 8-byte aligned, located by the offset/size table in the header. Strings are
+// (offset, length) refs into the pool. Loading never parses text: columns are
+// read straight out of the mapping.
+// Version 2: 64-bit pool offsets (version 1 wrapped past 4 GB of strings) and
+// emailHashCheck in the header.
+constexpr char kSnapshotMagic[8] = {'S', 'T', 'U', 'D', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kSnapshotVersion = 2;
+
+enum SnapshotSection : uint32_t {
+    kSnapshotNames,        // StringRef per student
+    kSnapshotSurnames,
+    kSnapshotEmails,
+    kSnapshotPhones,
+    kSnapshotEmailHashes,  // uint32_t, FlatEmailIndex::hashEmail of the email
+    kSnapshotBirthYears,   // int32_t
+    kSnapshotBirthMonths,  // uint8_t
+    kSnapshotBirthDays,    // uint8_t
+    kSnapshotGroupIds,     // uint32_t
+    kSnapshotRatings,      // double
+    kSnapshotGroupNames,   // StringRef per group, in id order
+    kSnapshotGroupStats,   // SnapshotGroupStats per group
+    kSnapshotPool,         // string bytes
+    kSnapshotSectionCount
+};
+
+struct StringRef {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+struct SnapshotGroupStats {
+    int32_t studentCount;
+    uint32_t reserved;
+    double totalRating;
+};
+
+// The stored email hashes come from std::hash, which differs between standard
+// libraries (and may change between their versions). The header records the hash of
+// this fixed string; if the loading build hashes it differently, the stored hashes
+// are ignored and recomputed.
+constexpr string_view kEmailHashProbe = "ivan.kravchenko17@student.org";
+
+inline uint32_t emailHashCheck() {
+    return FlatEmailIndex::hashEmail(kEmailHashProbe);
+}
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t emailHashCheck;
+    uint32_t reserved;
+    uint64_t studentCount;
+    uint64_t groupCount;
+    uint64_t fileSize;
+    uint64_t offsets[kSnapshotSectionCount];
+    uint64_t sizes[kSnapshotSectionCount];
+};
+
+// Builds a snapshot in memory, then writes it next to the target and renames it
+// into place, so a crash never leaves a half-written snapshot behind
+class SnapshotWriter {
+private:
+    SnapshotHeader header{};
+    string body;
+    string pool;
+
+    void beginSection(SnapshotSection section) {
+        body.resize((body.size() + 7) & ~size_t(7), '\0');
+        header.offsets[section] = sizeof(SnapshotHeader) + body.size();
+    }
+
+    void endSection(SnapshotSection section) {
+        header.sizes[section] = sizeof(SnapshotHeader) + body.size() - header.offsets[section];
+    }
+
+public:
+    SnapshotWriter(size_t students, size_t groups) {
+        memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.version = kSnapshotVersion;
+        header.headerSize = sizeof(SnapshotHeader);
+        header.emailHashCheck = emailHashCheck();
+        header.studentCount = students;
+        header.groupCount = groups;
+    }
+
+    // Column of value(i) for i in [0, count)
+    template <class ValueFn>
+    void addColumn(SnapshotSection section, size_t count, ValueFn&& value) {
+        beginSection(section);
+        for (size_t i = 0; i < count; i++) {
+            auto item = value(i);
+            body.append(reinterpret_cast<const char*>(&item), sizeof(item));
+        }
+        endSection(section);
+    }
+
+    // Column of StringRefs to text(i), whose bytes go to the pool
+    template <class TextFn>
+    void addStrings(SnapshotSection section, size_t count, TextFn&& text) {
+        addColumn(section, count, [&](size_t i) {
+            string_view value = text(i);
+            StringRef ref{pool.size(), static_cast<uint32_t>(value.size()), 0};
+            pool.append(value);
+            return ref;
+        });
+    }
+
+    bool writeTo(const string& filename) {
+        beginSection(kSnapshotPool);
+        body.append(pool);
+        endSection(kSnapshotPool);
+        header.fileSize = sizeof(SnapshotHeader) + body.size();
+
+        string temp = filename + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        bool ok = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+                  writeAll(fd, body.data(), body.size()) &&
+                  fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || rename(temp.c_str(), filename.c_str()) != 0) {
+            remove(temp.c_str());
+            return false;
+        }
+        return syncDirectory(filename);
+    }
+
+private:
+    // Makes the rename itself durable
+    static bool syncDirectory(const string& filename) {
+        size_t slash = filename.rfind('/');
+        string directory = slash == string::npos ? "." : filename.substr(0, max<size_t>(slash, 1));
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        bool ok = fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    static bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+};
+
+// Maps a snapshot and checks its header; columns point into the mapping
+class SnapshotReader {
+private:
+    MappedFile file;
+    const SnapshotHeader* header = nullptr;
+    string problem;
+
+public:
+    explicit SnapshotReader(const string& filename) : file(filename) {
+        if (!file.isOpen()) {
+            problem = "cannot open " + filename;
+        } else if (file.size() < sizeof(SnapshotHeader)) {
+            problem = "file too small";
+        } else {
+            header = reinterpret_cast<const SnapshotHeader*>(file.begin());
+            if (memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+                problem = "not a student snapshot";
+            } else if (header->version != kSnapshotVersion || header->headerSize != sizeof(SnapshotHeader)) {
+                problem = "unsupported snapshot version " + to_string(header->version);
+            } else if (header->fileSize != file.size()) {
+                problem = "truncated snapshot";
+            }
+            for (uint32_t s = 0; problem.empty() && s < kSnapshotSectionCount; s++) {
+                if (header->offsets[s] % 8 != 0 || header->offsets[s] > file.size() ||
+                    header->sizes[s] > file.size() - header->offsets[s]) {
+                    problem = "section " + to_string(s) + " out of bounds";
+                }
+            }
+        }
+        if (!problem.empty()) {
+            header = nullptr;
+        }
+    }
+
+    bool isValid() const {
+        return header != nullptr;
+    }
+
+    const string& error() const {
+        return problem;
+    }
+
+    size_t studentCount() const {
+        return header->studentCount;
+    }
+
+    size_t groupCount() const {
+        return header->groupCount;
+    }
+
+    // False if the file was written by a build whose FlatEmailIndex::hashEmail differs
+    bool emailHashesMatch() const {
+        return header->emailHashCheck == emailHashCheck();
+    }
+
+    size_t size() const {
+        return file.size();
+    }
+
+    // The section as `count` entries of T, or nullptr if its size does not match
+    template <class T>
+    const T* column(SnapshotSection section, size_t count) const {
+        if (header->sizes[section] != count * sizeof(T)) return nullptr;
+        return reinterpret_cast<const T*>(file.begin() + header->offsets[section]);
+    }
+
+    // False for a ref outside the pool
+    bool text(StringRef ref, string_view& value) const {
+        uint64_t poolSize = header->sizes[kSnapshotPool];
+        if (ref.offset > poolSize || ref.length > poolSize - ref.offset) return false;
+        value = string_view(file.begin() + header->offsets[kSnapshotPool] + ref.offset, ref.length);
+        return true;
+    }
+};
+
+#endif // SNAPSHOT_FILE_H
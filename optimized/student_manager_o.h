@@ -8,6 +8,12 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <chrono>
+#include "../common/mapped_csv.h"
+#include "../common/flat_email_index.h"
+#include "group_table.h"
+#include "group_ranking.h"
+#include "snapshot_file.h"
 
 using namespace std;
 
@@ -18,7 +24,7 @@ struct Student {
     int m_birth_year;
     int m_birth_month;
     int m_birth_day;
-    string m_group;
+    uint32_t m_groupId;
     double m_rating;
     string m_phone_number;
 };
@@ -32,140 +38,558 @@ struct GroupStats {
     }
 };
 
+struct GroupSummary {
+    uint32_t groupId;
+    string name;
+    int studentCount;
+    double averageRating;
+};
+
+Student makeStudent(const StudentRow& row, uint32_t groupId) {
+    Student student;
+    student.m_name.assign(row.name);
+    student.m_surname.assign(row.surname);
+    student.m_email.assign(row.email);
+    student.m_birth_year = row.birthYear;
+    student.m_birth_month = row.birthMonth;
+    student.m_birth_day = row.birthDay;
+    student.m_groupId = groupId;
+    student.m_rating = row.rating;
+    student.m_phone_number.assign(row.phone);
+    return student;
+}
+
 class OptimizedStudentDB {
 private:
-    unordered_map<string, Student> studentsByEmail;
-    unordered_map<string, GroupStats> groupStats;
+    vector<Student> students;       // contiguous records
+    FlatEmailIndex emailIndex;      // email -> position in students
+    GroupTable groups;
+    vector<GroupStats> groupStats;  // indexed by group id
+    GroupRanking<int> groupsByCount;
+    GroupRanking<double> groupsByRating;
     
-    string cachedMaxCountGroup;
+    uint32_t cachedMaxCountGroup = GroupRanking<int>::kNone;
     int cachedMaxCount = 0;
-    string cachedMaxRatingGroup;
+    uint32_t cachedMaxRatingGroup = GroupRanking<double>::kNone;
     double cachedMaxRating = 0.0;
-    bool cacheValid = false;
+
+    uint32_t internGroup(string_view name) {
+        uint32_t id = groups.intern(name);
+        if (id >= groupStats.size()) {
+            groupStats.resize(id + 1);
+        }
+        return id;
+    }
+
+    // Existing record for the email, or a new default one appended to students
+    Student& upsert(string_view email, bool& existed) {
+        uint32_t hash = FlatEmailIndex::hashEmail(email);
+        uint32_t index = emailIndex.find(email, hash, students);
+        existed = index != FlatEmailIndex::kNotFound;
+        if (existed) {
+            return students[index];
+        }
+
+        emailIndex.insert(hash, static_cast<uint32_t>(students.size()));
+        students.emplace_back();
+        students.back().m_email.assign(email);
+        return students.back();
+    }
+
+    void reserveStudents(size_t extra) {
+        students.reserve(students.size() + extra);
+        emailIndex.reserve(students.size() + extra);
+    }
+
+    void removeFromStats(const Student& student) {
+        GroupStats& group = groupStats[student.m_groupId];
+        group.studentCount--;
+        group.totalRating -= student.m_rating;
+    }
+
+    // Moves one group to its new place in both rankings, O(log G)
+    void rerankGroup(uint32_t id) {
+        const GroupStats& stats = groupStats[id];
+        if (stats.studentCount > 0) {
+            groupsByCount.update(id, stats.studentCount);
+            groupsByRating.update(id, stats.getAverageRating());
+        } else {
+            groupsByCount.remove(id);
+            groupsByRating.remove(id);
+        }
+    }
+
+    template <class Changes, class GroupIdFn>
+    size_t applyGroupChanges(const Changes& changes, GroupIdFn&& groupIdOf) {
+        const size_t kPrefetchDistance = 8;
+
+        vector<uint32_t> hashes(changes.size());
+        for (size_t i = 0; i < changes.size(); i++) {
+            hashes[i] = FlatEmailIndex::hashEmail(changes[i].first);
+        }
+        for (size_t i = 0; i < min(kPrefetchDistance, changes.size()); i++) {
+            emailIndex.prefetch(hashes[i]);
+        }
+
+        vector<bool> touched(groupStats.size(), false);
+        vector<uint32_t> touchedIds;
+        auto touch = [&](uint32_t id) {
+            if (id >= touched.size()) {
+                touched.resize(groupStats.size(), false);
+            }
+            if (!touched[id]) {
+                touched[id] = true;
+                touchedIds.push_back(id);
+            }
+        };
+
+        size_t found = 0;
+        for (size_t i = 0; i < changes.size(); i++) {
+            if (i + kPrefetchDistance < changes.size()) {
+                emailIndex.prefetch(hashes[i + kPrefetchDistance]);
+            }
+            uint32_t index = emailIndex.find(changes[i].first, hashes[i], students);
+            if (index == FlatEmailIndex::kNotFound) {
+                continue;
+            }
+            uint32_t newGroupId = groupIdOf(i);
+            if (newGroupId >= groupStats.size()) {
+                continue;
+            }
+            found++;
+
+            Student& student = students[index];
+            if (student.m_groupId == newGroupId) {
+                continue;
+            }
+            touch(student.m_groupId);
+            touch(newGroupId);
+            removeFromStats(student);
+            student.m_groupId = newGroupId;
+            groupStats[newGroupId].studentCount++;
+            groupStats[newGroupId].totalRating += student.m_rating;
+        }
+
+        for (uint32_t id : touchedIds) {
+            rerankGroup(id);
+        }
+        refreshCache();
+        return found;
+    }
+
+    void refreshCache() {
+        cachedMaxCountGroup = groupsByCount.top();
+        cachedMaxCount = cachedMaxCountGroup == GroupRanking<int>::kNone
+                             ? 0 : groupStats[cachedMaxCountGroup].studentCount;
+        cachedMaxRatingGroup = groupsByRating.top();
+        cachedMaxRating = cachedMaxRatingGroup == GroupRanking<double>::kNone
+                              ? 0.0 : groupStats[cachedMaxRatingGroup].getAverageRating();
+    }
 
 public:
-    void loadFromCSV(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
+    LoadStats loadFromCSV(const string& filename) {
+        LoadStats stats;
+        auto startTime = chrono::steady_clock::now();
+
+        MappedFile file(filename);
+        if (!file.isOpen()) {
             cerr << "Error opening file!" << endl;
-            return;
+            return stats;
         }
-        
-        string line;
-        getline(file, line);
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            vector<string> fields;
-            
-            while (getline(ss, field, ',')) {
-                fields.push_back(field);
+
+        const char* begin = skipCSVHeader(file.begin(), file.end());
+        reserveStudents(countLines(begin, file.end()));
+
+        StudentRow row;
+        forEachLine(begin, file.end(), [&](string_view line) {
+            if (!parseStudentRow(line, row)) {
+                return;
             }
-            
-            if (fields.size() >= 9) {
-                Student student;
-                student.m_name = fields[0];
-                student.m_surname = fields[1];
-                student.m_email = fields[2];
-                student.m_birth_year = stoi(fields[3]);
-                student.m_birth_month = stoi(fields[4]);
-                student.m_birth_day = stoi(fields[5]);
-                student.m_group = fields[6];
-                student.m_rating = stod(fields[7]);
-                student.m_phone_number = fields[8];
-                
-                studentsByEmail[student.m_email] = student;
-                
-                groupStats[student.m_group].studentCount++;
-                groupStats[student.m_group].totalRating += student.m_rating;
+
+            bool existed;
+            Student& student = upsert(row.email, existed);
+
+            if (existed) {
+                removeFromStats(student);
             }
-        }
-        
-        file.close();
+
+            student.m_name.assign(row.name);
+            student.m_surname.assign(row.surname);
+            student.m_birth_year = row.birthYear;
+            student.m_birth_month = row.birthMonth;
+            student.m_birth_day = row.birthDay;
+            student.m_groupId = internGroup(row.group);
+            student.m_rating = row.rating;
+            student.m_phone_number.assign(row.phone);
+
+            GroupStats& group = groupStats[student.m_groupId];
+            group.studentCount++;
+            group.totalRating += student.m_rating;
+            stats.rows++;
+        });
+
         rebuildCache();
+
+        stats.bytes = file.size();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return stats;
     }
     
-    void rebuildCache() {
-        cachedMaxCount = 0;
-        cachedMaxRating = 0.0;
-        
-        for (const auto& pair : groupStats) {
-            if (pair.second.studentCount > cachedMaxCount) {
-                cachedMaxCount = pair.second.studentCount;
-                cachedMaxCountGroup = pair.first;
+    // Same as loadFromCSV, but chunks are parsed and aggregated on `threads` workers (0 = all cores)
+    LoadStats loadFromCSVParallel(const string& filename, unsigned threads = 0) {
+        LoadStats stats;
+        auto startTime = chrono::steady_clock::now();
+
+        MappedFile file(filename);
+        if (!file.isOpen()) {
+            cerr << "Error opening file!" << endl;
+            return stats;
+        }
+
+        const char* begin = skipCSVHeader(file.begin(), file.end());
+        auto chunks = splitAtLines(begin, file.end(), threads > 0 ? threads : defaultThreadCount());
+        vector<vector<Student>> parsed(chunks.size());
+        vector<GroupTable> localGroups(chunks.size());
+        vector<vector<GroupStats>> partialStats(chunks.size());
+
+        // Workers intern into a chunk-local table; ids are remapped to global ones below
+        parallelForChunks(chunks, [&](size_t index, const char* chunkBegin, const char* chunkEnd) {
+            vector<Student>& students = parsed[index];
+            GroupTable& local = localGroups[index];
+            vector<GroupStats>& partial = partialStats[index];
+            students.reserve(countLines(chunkBegin, chunkEnd));
+
+            StudentRow row;
+            forEachLine(chunkBegin, chunkEnd, [&](string_view line) {
+                if (!parseStudentRow(line, row)) {
+                    return;
+                }
+                uint32_t localId = local.intern(row.group);
+                if (localId >= partial.size()) {
+                    partial.resize(localId + 1);
+                }
+                students.push_back(makeStudent(row, localId));
+
+                partial[localId].studentCount++;
+                partial[localId].totalRating += row.rating;
+            });
+        });
+
+        // Interning the local tables in chunk order gives the same ids as a serial load
+        vector<vector<uint32_t>> globalIds(chunks.size());
+        size_t total = 0;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            total += parsed[i].size();
+            globalIds[i].resize(localGroups[i].size());
+            for (uint32_t localId = 0; localId < localGroups[i].size(); localId++) {
+                uint32_t id = internGroup(localGroups[i].name(localId));
+                globalIds[i][localId] = id;
+                groupStats[id].studentCount += partialStats[i][localId].studentCount;
+                groupStats[id].totalRating += partialStats[i][localId].totalRating;
             }
-            
-            double avgRating = pair.second.getAverageRating();
-            if (avgRating > cachedMaxRating) {
-                cachedMaxRating = avgRating;
-                cachedMaxRatingGroup = pair.first;
+        }
+        reserveStudents(total);
+
+        // Chunks are merged in file order, so a repeated email keeps its last row like in loadFromCSV
+        for (size_t i = 0; i < parsed.size(); i++) {
+            for (auto& student : parsed[i]) {
+                student.m_groupId = globalIds[i][student.m_groupId];
+                bool existed;
+                Student& slot = upsert(student.m_email, existed);
+                if (existed) {
+                    removeFromStats(slot);
+                }
+                slot = move(student);
             }
+            stats.rows += parsed[i].size();
+        }
+
+        rebuildCache();
+
+        stats.bytes = file.size();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return stats;
+    }
+
+    // Writes the students, the group names and the current group totals as a binary snapshot
+    bool saveSnapshot(const string& filename) const {
+        size_t n = students.size();
+        SnapshotWriter writer(n, groupStats.size());
+        writer.addStrings(kSnapshotNames, n, [&](size_t i) -> string_view { return students[i].m_name; });
+        writer.addStrings(kSnapshotSurnames, n, [&](size_t i) -> string_view { return students[i].m_surname; });
+        writer.addStrings(kSnapshotEmails, n, [&](size_t i) -> string_view { return students[i].m_email; });
+        writer.addStrings(kSnapshotPhones, n, [&](size_t i) -> string_view { return students[i].m_phone_number; });
+        writer.addColumn(kSnapshotEmailHashes, n, [&](size_t i) { return FlatEmailIndex::hashEmail(students[i].m_email); });
+        writer.addColumn(kSnapshotBirthYears, n, [&](size_t i) { return int32_t(students[i].m_birth_year); });
+        writer.addColumn(kSnapshotBirthMonths, n, [&](size_t i) { return uint8_t(students[i].m_birth_month); });
+        writer.addColumn(kSnapshotBirthDays, n, [&](size_t i) { return uint8_t(students[i].m_birth_day); });
+        writer.addColumn(kSnapshotGroupIds, n, [&](size_t i) { return students[i].m_groupId; });
+        writer.addColumn(kSnapshotRatings, n, [&](size_t i) { return students[i].m_rating; });
+        writer.addStrings(kSnapshotGroupNames, groupStats.size(), [&](size_t id) -> string_view {
+            return groups.name(id);
+        });
+        writer.addColumn(kSnapshotGroupStats, groupStats.size(), [&](size_t id) {
+            return SnapshotGroupStats{groupStats[id].studentCount, 0, groupStats[id].totalRating};
+        });
+        return writer.writeTo(filename);
+    }
+
+    // Replaces the contents with a snapshot written by saveSnapshot. Nothing is parsed:
+    // strings are copied out of the pool, the email index is rebuilt from the stored
+    // hashes (recomputed only if this build hashes differently, see emailHashCheck) and
+    // group totals are taken as saved; only the rankings are rebuilt, O(G log G).
+    LoadStats loadFromSnapshot(const string& filename) {
+        LoadStats stats;
+        auto startTime = chrono::steady_clock::now();
+
+        SnapshotReader snapshot(filename);
+        if (!snapshot.isValid()) {
+            cerr << "Error loading snapshot: " << snapshot.error() << endl;
+            return stats;
         }
+
+        size_t n = snapshot.studentCount();
+        size_t groupTotal = snapshot.groupCount();
+        auto names = snapshot.column<StringRef>(kSnapshotNames, n);
+        auto surnames = snapshot.column<StringRef>(kSnapshotSurnames, n);
+        auto emails = snapshot.column<StringRef>(kSnapshotEmails, n);
+        auto phones = snapshot.column<StringRef>(kSnapshotPhones, n);
+        auto hashes = snapshot.column<uint32_t>(kSnapshotEmailHashes, n);
+        auto years = snapshot.column<int32_t>(kSnapshotBirthYears, n);
+        auto months = snapshot.column<uint8_t>(kSnapshotBirthMonths, n);
+        auto days = snapshot.column<uint8_t>(kSnapshotBirthDays, n);
+        auto groupIds = snapshot.column<uint32_t>(kSnapshotGroupIds, n);
+        auto ratings = snapshot.column<double>(kSnapshotRatings, n);
+        auto groupNames = snapshot.column<StringRef>(kSnapshotGroupNames, groupTotal);
+        auto savedStats = snapshot.column<SnapshotGroupStats>(kSnapshotGroupStats, groupTotal);
+        if (!names || !surnames || !emails || !phones || !hashes || !years || !months ||
+            !days || !groupIds || !ratings || !groupNames || !savedStats) {
+            cerr << "Error loading snapshot: column size mismatch" << endl;
+            return stats;
+        }
+
+        bool storedHashes = snapshot.emailHashesMatch();
+        students.clear();
+        emailIndex = FlatEmailIndex();
+        groups = GroupTable();
+        groupStats.clear();
+
+        auto copyText = [&](StringRef ref, string& out) {
+            string_view value;
+            if (!snapshot.text(ref, value)) return false;
+            out.assign(value);
+            return true;
+        };
+
+        bool ok = true;
+        string name;
+        for (uint32_t id = 0; ok && id < groupTotal; id++) {
+            ok = copyText(groupNames[id], name) && internGroup(name) == id;
+            if (ok) {
+                groupStats[id].studentCount = savedStats[id].studentCount;
+                groupStats[id].totalRating = savedStats[id].totalRating;
+            }
+        }
+
+        reserveStudents(n);
+        students.resize(ok ? n : 0);
+        for (size_t i = 0; ok && i < n; i++) {
+            Student& student = students[i];
+            ok = copyText(names[i], student.m_name) && copyText(surnames[i], student.m_surname) &&
+                 copyText(emails[i], student.m_email) && copyText(phones[i], student.m_phone_number) &&
+                 groupIds[i] < groupTotal;
+            student.m_birth_year = years[i];
+            student.m_birth_month = months[i];
+            student.m_birth_day = days[i];
+            student.m_groupId = groupIds[i];
+            student.m_rating = ratings[i];
+            uint32_t hash = storedHashes ? hashes[i] : FlatEmailIndex::hashEmail(student.m_email);
+            emailIndex.insert(hash, static_cast<uint32_t>(i));
+        }
+        if (!ok) {
+            cerr << "Error loading snapshot: corrupt string or group reference" << endl;
+            *this = OptimizedStudentDB();
+            return stats;
+        }
+
+        rebuildCache();
+
+        stats.rows = n;
+        stats.bytes = snapshot.size();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        return stats;
+    }
+
+    // Full O(G log G) rebuild of the rankings, only needed after a bulk load
+    void rebuildCache() {
+        groupsByCount.clear();
+        groupsByRating.clear();
         
-        cacheValid = true;
+        for (uint32_t id = 0; id < groupStats.size(); id++) {
+            rerankGroup(id);
+        }
+        
+        refreshCache();
     }
     
-    string findGroupWithMostStudents() {
-        if (!cacheValid) rebuildCache();
-        return cachedMaxCountGroup;
+    const string& findGroupWithMostStudents() const {
+        return groups.name(cachedMaxCountGroup);
     }
     
+    // An unknown email changes nothing, so it does not create the group either
     bool changeGroupByEmail(const string& email, const string& newGroup) {
-        auto it = studentsByEmail.find(email);
-        if (it == studentsByEmail.end()) {
+        Student* student = findStudent(email);
+        if (!student) {
             return false;
         }
-        
-        Student& student = it->second;
-        string oldGroup = student.m_group;
-        
-        if (oldGroup == newGroup) {
-            return true;
+
+        moveStudent(*student, internGroup(newGroup));
+        return true;
+    }
+
+    // Op2 without touching group names: one email lookup, two array updates
+    bool changeGroupByEmail(const string& email, uint32_t newGroupId) {
+        Student* student = findStudent(email);
+        if (!student || newGroupId >= groupStats.size()) {
+            return false;
         }
         
-        groupStats[oldGroup].studentCount--;
-        groupStats[oldGroup].totalRating -= student.m_rating;
-        
-        if (groupStats[oldGroup].studentCount == 0) {
-            groupStats.erase(oldGroup);
+        moveStudent(*student, newGroupId);
+        return true;
+    }
+
+    // Lookup only; the map itself is not modified after loading, so this may
+    // run concurrently with moveStudent on other students
+    Student* findStudent(const string& email) {
+        uint32_t index = emailIndex.find(email, students);
+        return index == FlatEmailIndex::kNotFound ? nullptr : &students[index];
+    }
+
+    // Second half of Op2: updates the student's group, the stats and the rankings
+    void moveStudent(Student& student, uint32_t newGroupId) {
+        if (student.m_groupId == newGroupId) {
+            return;
         }
         
-        student.m_group = newGroup;
+        uint32_t oldGroupId = student.m_groupId;
+        removeFromStats(student);
         
-        groupStats[newGroup].studentCount++;
-        groupStats[newGroup].totalRating += student.m_rating;
+        student.m_groupId = newGroupId;
         
-        cacheValid = false;
+        groupStats[newGroupId].studentCount++;
+        groupStats[newGroupId].totalRating += student.m_rating;
         
-        return true;
+        rerankGroup(oldGroupId);
+        rerankGroup(newGroupId);
+        refreshCache();
     }
-    
-    string findGroupWithHighestRating() {
-        if (!cacheValid) rebuildCache();
+
+    // Op2 for many students at once. Hash buckets are prefetched a few changes ahead,
+    // group stats are updated in place, and each touched group is re-ranked once at
+    // the end, followed by one cache refresh. The result is the same as applying the
+    // changes one by one. Returns how many students were found.
+    size_t changeGroupsByEmail(const vector<pair<string, uint32_t>>& changes) {
+        return applyGroupChanges(changes, [&](size_t i) { return changes[i].second; });
+    }
+
+    // Same with group names; unknown groups are created, but only for emails that exist
+    size_t changeGroupsByEmail(const vector<pair<string, string>>& changes) {
+        return applyGroupChanges(changes, [&](size_t i) { return internGroup(changes[i].second); });
+    }
+
+    uint32_t internGroupName(const string& name) {
+        return internGroup(name);
+    }
+
+    uint32_t mostStudentsGroupId() const {
+        return cachedMaxCountGroup;
+    }
+
+    uint32_t highestRatingGroupId() const {
         return cachedMaxRatingGroup;
     }
     
+    const string& findGroupWithHighestRating() const {
+        return groups.name(cachedMaxRatingGroup);
+    }
+
+    // Ranked queries; ties are broken by group id, i.e. by first appearance in the data
+
+    // Up to k groups with the most students, largest first, O(k + log G)
+    vector<GroupSummary> topGroupsByStudents(size_t k) const {
+        vector<GroupSummary> result;
+        for (const auto& entry : groupsByCount.top(k)) {
+            result.push_back(summarize(entry.first));
+        }
+        return result;
+    }
+
+    // Up to k groups with the highest average rating, best first, O(k + log G)
+    vector<GroupSummary> topGroupsByRating(size_t k) const {
+        vector<GroupSummary> result;
+        for (const auto& entry : groupsByRating.top(k)) {
+            result.push_back(summarize(entry.first));
+        }
+        return result;
+    }
+
+    // 1-based rank of a group by student count, 0 if the group has no students, O(log G)
+    size_t groupRankByStudents(const string& group) const {
+        uint32_t id = groups.find(group);
+        size_t rank = id == GroupTable::kNoGroup ? groupsByCount.kNone : groupsByCount.rankOf(id);
+        return rank == groupsByCount.kNone ? 0 : rank + 1;
+    }
+
+    // 1-based rank of a group by average rating, 0 if the group has no students, O(log G)
+    size_t groupRankByRating(const string& group) const {
+        uint32_t id = groups.find(group);
+        size_t rank = id == GroupTable::kNoGroup ? groupsByRating.kNone : groupsByRating.rankOf(id);
+        return rank == groupsByRating.kNone ? 0 : rank + 1;
+    }
+
+    GroupSummary summarize(uint32_t groupId) const {
+        const GroupStats& stats = groupStats[groupId];
+        return {groupId, groups.name(groupId), stats.studentCount, stats.getAverageRating()};
+    }
+
+    const string& groupName(uint32_t groupId) const {
+        return groups.name(groupId);
+    }
+    
+    size_t groupCount() const {
+        return groupStats.size();
+    }
+    
     int getStudentCount() const {
-        return studentsByEmail.size();
+        return students.size();
     }
     
     vector<string> getAllEmails() const {
         vector<string> emails;
-        emails.reserve(studentsByEmail.size());
-        for (const auto& pair : studentsByEmail) {
-            emails.push_back(pair.first);
+        emails.reserve(students.size());
+        for (const auto& student : students) {
+            emails.push_back(student.m_email);
         }
         return emails;
     }
     
+    // Groups that currently have at least one student
+    vector<uint32_t> getAllGroupIds() const {
+        vector<uint32_t> ids;
+        for (uint32_t id = 0; id < groupStats.size(); id++) {
+            if (groupStats[id].studentCount > 0) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+    
     vector<string> getAllGroups() const {
-        vector<string> groups;
-        groups.reserve(groupStats.size());
-        for (const auto& pair : groupStats) {
-            groups.push_back(pair.first);
+        vector<string> names;
+        for (uint32_t id : getAllGroupIds()) {
+            names.push_back(groups.name(id));
         }
-        return groups;
+        return names;
     }
 };
 
@@ -5,7 +5,7 @@ Script to run all measurements, collect data, and generate plots
 
 import subprocess
 import os
-import re
+import sys
 import json
 from pathlib import Path
 import matplotlib
@@ -18,14 +18,26 @@ from datetime import datetime
 # Set seaborn style for better-looking plots
 sns.set_theme(style="whitegrid")
 
+
+def option_value(args, name, default):
+    """The value after `name` in a benchmark argument list, or `default`"""
+    if name in args:
+        index = args.index(name)
+        if index + 1 < len(args):
+            return args[index + 1]
+    return default
+
 class MeasurementRunner:
-    def __init__(self, root_dir):
+    def __init__(self, root_dir, benchmark_args=(), timeout=None):
         self.root_dir = Path(root_dir)
+        self.benchmark_args = list(benchmark_args)
+        self.timeout = timeout  # seconds per benchmark, 0 = no limit, None = benchmark_timeout
         self.results = {}
+        self.scaling = {}
         self.output_dir = self.root_dir / "results"
         self.output_dir.mkdir(exist_ok=True)
         
-    def compile_and_run(self, source_path, executable_name, work_dir):
+    def compile_and_run(self, source_path, executable_name, work_dir, args=(), timeout=30):
         """Compile and run a C++ program, return its output"""
         source_file = work_dir / source_path
         executable = work_dir / executable_name
@@ -35,7 +47,7 @@ class MeasurementRunner:
         print(f"{'='*60}")
         
         # Compile
-        compile_cmd = ["g++", str(source_file), "-o", str(executable), "-std=c++17", "-O2"]
+        compile_cmd = ["g++", str(source_file), "-o", str(executable), "-std=c++17", "-O2", "-pthread"]
         try:
             result = subprocess.run(compile_cmd, capture_output=True, text=True, check=True)
             print(f"✓ Compilation successful")
@@ -46,8 +58,8 @@ class MeasurementRunner:
         # Run
         print(f"Running {executable_name}...")
         try:
-            result = subprocess.run([str(executable)], capture_output=True, text=True, 
-                                   cwd=work_dir, timeout=30)
+            result = subprocess.run([str(executable), *args], capture_output=True, text=True, 
+                                   cwd=work_dir, timeout=timeout)
             print(f"✓ Execution completed")
             return result.stdout
         except subprocess.TimeoutExpired:
@@ -57,44 +69,46 @@ class MeasurementRunner:
             print(f"✗ Execution failed: {e}")
             return None
     
-    def parse_output(self, output):
-        """Parse the output from measurement programs"""
-        if not output:
+    def read_json_result(self, json_file):
+        """Load the JSON result written by a benchmark (common/benchmark.h)"""
+        try:
+            with open(json_file) as f:
+                return json.load(f)
+        except (OSError, json.JSONDecodeError) as e:
+            print(f"✗ Could not read {json_file}: {e}")
             return None
+    
+    def run_all_measurements(self):
+        """Run all measurement programs on the default dataset"""
+        self.results = self.run_measurements(self.benchmark_args)
         
-        data = {}
-        
-        # Extract duration
-        duration_match = re.search(r'Duration:\s*(\d+)\s*ms', output)
-        if duration_match:
-            data['duration_ms'] = int(duration_match.group(1))
-        
-        # Extract total operations
-        total_ops_match = re.search(r'Total operations:\s*(\d+)', output)
-        if total_ops_match:
-            data['total_operations'] = int(total_ops_match.group(1))
-        
-        # Extract operations per second (handles scientific notation like 3.08928e+06)
-        ops_per_sec_match = re.search(r'Operations per second:\s*([\d.eE+\-]+)', output)
-        if ops_per_sec_match:
-            data['ops_per_second'] = float(ops_per_sec_match.group(1))
-        
-        # Extract individual operation counts
-        op1_match = re.search(r'Operation 1.*?:\s*(\d+)', output)
-        op2_match = re.search(r'Operation 2.*?:\s*(\d+)', output)
-        op3_match = re.search(r'Operation 3.*?:\s*(\d+)', output)
-        
-        if op1_match:
-            data['op1_count'] = int(op1_match.group(1))
-        if op2_match:
-            data['op2_count'] = int(op2_match.group(1))
-        if op3_match:
-            data['op3_count'] = int(op3_match.group(1))
+        # Save results to JSON
+        results_file = self.output_dir / 'measurement_results.json'
+        with open(results_file, 'w') as f:
+            json.dump(self.results, f, indent=2)
+        print(f"\n✓ Results saved to {results_file}")
         
-        return data
+        return self.results
     
-    def run_all_measurements(self):
-        """Run all measurement programs"""
+    def benchmark_timeout(self, args, work_dir):
+        """Seconds one benchmark may run before it is killed: the --seconds, --warmup and
+        --perf-seconds it is asked for, plus 60 s and 30 s per 100 MB of dataset for loading
+        and lookups. A fixed op list (--ops, --replay) has no known length and no limit."""
+        if self.timeout is not None:
+            return self.timeout or None
+        if '--ops' in args or '--replay' in args:
+            return None
+        dataset = Path(option_value(args, '--dataset', 'students.csv'))
+        if not dataset.is_absolute():
+            dataset = work_dir / dataset
+        dataset_bytes = dataset.stat().st_size if dataset.exists() else 0
+        run_seconds = (float(option_value(args, '--seconds', 10)) + float(option_value(args, '--warmup', 1)) +
+                       3 * float(option_value(args, '--perf-seconds', 0.5)))
+        return run_seconds + 60 + 30 * dataset_bytes / 100e6
+    
+    def run_measurements(self, args):
+        """Run every measurement program with `args`, return the results by implementation"""
+        results = {}
         measurements = [
             {
                 'name': 'Hash Table',
@@ -114,6 +128,12 @@ class MeasurementRunner:
                 'executable': 'main',
                 'work_dir': self.root_dir / 'standart' / 'avl'
             },
+            {
+                'name': 'B+ Tree',
+                'source': 'measure.cpp',
+                'executable': 'main',
+                'work_dir': self.root_dir / 'standart' / 'btree'
+            },
             {
                 'name': 'Optimized',
                 'source': 'measure_optimized.cpp',
@@ -123,30 +143,67 @@ class MeasurementRunner:
         ]
         
         for measurement in measurements:
+            json_file = measurement['work_dir'] / 'benchmark_result.json'
+            if json_file.exists():
+                json_file.unlink()
             output = self.compile_and_run(
                 measurement['source'],
                 measurement['executable'],
-                measurement['work_dir']
+                measurement['work_dir'],
+                ['--json', str(json_file), *args],
+                self.benchmark_timeout(args, measurement['work_dir'])
             )
             
             if output:
                 print(f"\n--- Output for {measurement['name']} ---")
                 print(output)
                 
-                parsed_data = self.parse_output(output)
+                parsed_data = self.read_json_result(json_file)
                 if parsed_data:
-                    self.results[measurement['name']] = parsed_data
+                    results[measurement['name']] = parsed_data
                     print(f"✓ Data collected for {measurement['name']}")
                 else:
                     print(f"✗ Failed to parse output for {measurement['name']}")
         
-        # Save results to JSON
-        results_file = self.output_dir / 'measurement_results.json'
-        with open(results_file, 'w') as f:
-            json.dump(self.results, f, indent=2)
-        print(f"\n✓ Results saved to {results_file}")
-        
-        return self.results
+        return results
+    
+    def generate_dataset(self, rows):
+        """Generate results/datasets/students_<rows>.csv with tools/generate_students.cpp, return its path"""
+        dataset_dir = self.output_dir / 'datasets'
+        dataset_dir.mkdir(exist_ok=True)
+        dataset = dataset_dir / f'students_{rows}.csv'
+        if dataset.exists():
+            return dataset
+        
+        generator = dataset_dir / 'generate_students'
+        if not generator.exists():
+            compile_cmd = ["g++", str(self.root_dir / 'tools' / 'generate_students.cpp'), "-o", str(generator),
+                           "-std=c++17", "-O2", "-pthread"]
+            try:
+                subprocess.run(compile_cmd, capture_output=True, text=True, check=True)
+            except subprocess.CalledProcessError as e:
+                print(f"✗ Compilation of the generator failed: {e.stderr}")
+                return None
+        
+        print(f"Generating {rows:,} students...")
+        subprocess.run([str(generator), '--rows', str(rows), '--output', str(dataset)], check=True)
+        return dataset
+    
+    def run_scaling_sweep(self, sizes):
+        """Run all measurement programs on generated datasets of each size"""
+        for rows in sizes:
+            dataset = self.generate_dataset(rows)
+            if dataset is None:
+                return self.scaling
+            print(f"\n--- Dataset with {rows:,} students ---")
+            self.scaling[rows] = self.run_measurements(['--dataset', str(dataset), *self.benchmark_args])
+        
+        scaling_file = self.output_dir / 'scaling_results.json'
+        with open(scaling_file, 'w') as f:
+            json.dump(self.scaling, f, indent=2)
+        print(f"\n✓ Scaling results saved to {scaling_file}")
+        
+        return self.scaling
     
     def generate_plots(self):
         """Generate various plots from collected data"""
@@ -307,6 +364,46 @@ class MeasurementRunner:
         # Generate individual operation comparison plot
         self._generate_operation_comparison_plot()
     
+    def generate_scaling_plot(self):
+        """Plot ops/sec and Op2 p99 latency against dataset size, one line per implementation"""
+        if not self.scaling:
+            return
+        
+        sizes = sorted(self.scaling)
+        implementations = sorted({impl for results in self.scaling.values() for impl in results})
+        colors = sns.color_palette("husl", len(implementations))
+        fig, axes = plt.subplots(1, 2, figsize=(14, 5))
+        
+        for impl, color in zip(implementations, colors):
+            points = [(rows, self.scaling[rows][impl]) for rows in sizes if impl in self.scaling[rows]]
+            rows = [point[0] for point in points]
+            axes[0].plot(rows, [data['ops_per_second'] for _, data in points],
+                         marker='o', linewidth=2, color=color, label=impl)
+            axes[1].plot(rows, [data['latency_ns']['op2']['p99'] for _, data in points],
+                         marker='o', linewidth=2, color=color, label=impl)
+        
+        titles = [('Operations per Second', 'Throughput vs Dataset Size'),
+                  ('Op2 p99 Latency (ns)', 'Change Group Tail Latency vs Dataset Size')]
+        for ax, (ylabel, title) in zip(axes, titles):
+            ax.set_xscale('log')
+            ax.set_yscale('log')
+            ax.set_xlabel('Students', fontsize=12, fontweight='bold')
+            ax.set_ylabel(ylabel, fontsize=12, fontweight='bold')
+            ax.set_title(title, fontsize=14, fontweight='bold')
+            ax.grid(alpha=0.3, which='both')
+            ax.legend()
+        
+        plt.tight_layout()
+        plot_file = self.output_dir / 'scaling.png'
+        plt.savefig(plot_file, dpi=300, bbox_inches='tight')
+        print(f"✓ Scaling plot saved to {plot_file}")
+        
+        pdf_file = self.output_dir / 'scaling.pdf'
+        plt.savefig(pdf_file, bbox_inches='tight')
+        print(f"✓ Scaling plot saved to {pdf_file}")
+        
+        plt.close()
+    
     def _generate_operation_comparison_plot(self):
         """Generate detailed operation comparison plot"""
         fig, axes = plt.subplots(1, 3, figsize=(15, 5))
@@ -389,6 +486,30 @@ class MeasurementRunner:
                 f.write(f"  Operation 1 count: {data['op1_count']:,}\n")
                 f.write(f"  Operation 2 count: {data['op2_count']:,}\n")
                 f.write(f"  Operation 3 count: {data['op3_count']:,}\n")
+                if 'lookups_per_second' in data:
+                    f.write(f"  Email lookups per second: {data['lookups_per_second']:,.0f}\n")
+                for op, latency in sorted(data.get('latency_ns', {}).items()):
+                    f.write(f"  {op.capitalize()} latency (ns): p50 {latency['p50']:,.0f} | "
+                            f"p99 {latency['p99']:,.0f} | p999 {latency['p999']:,.0f} | "
+                            f"max {latency['max']:,.0f}\n")
+                if data.get('perf_error'):
+                    f.write(f"  Perf counters: {data['perf_error']}\n")
+                for op, counters in data.get('perf_counters', {}).items():
+                    values = [f"{name} {value:,.2f}" for name, value in counters.items() if name != 'ops']
+                    if values:
+                        f.write(f"  {op.capitalize()} counters per op: " + " | ".join(values) + "\n")
+
+            if self.scaling:
+                f.write("\nSCALING (operations per second by dataset size)\n")
+                f.write("-"*70 + "\n")
+                sizes = sorted(self.scaling)
+                f.write(f"{'Implementation':<16}" + "".join(f"{rows:>14,}" for rows in sizes) + "\n")
+                for impl in sorted({impl for results in self.scaling.values() for impl in results}):
+                    f.write(f"{impl:<16}")
+                    for rows in sizes:
+                        data = self.scaling[rows].get(impl)
+                        f.write(f"{data['ops_per_second']:>14,.0f}" if data else f"{'-':>14}")
+                    f.write("\n")
 
             f.write("\n" + "="*70 + "\n")
         
@@ -405,14 +526,31 @@ def main():
     print("╚═══════════════════════════════════════════════════════════════╝")
     
     root_dir = os.path.dirname(os.path.abspath(__file__))
-    runner = MeasurementRunner(root_dir)
+    # --sizes 100000,1000000,10000000 adds a sweep over generated datasets; --timeout N
+    # kills a benchmark after N seconds (0 = never); other options go to every benchmark,
+    # e.g. --email-skew 0.99 or --replay /abs/trace.bin
+    args = sys.argv[1:]
+    sizes = []
+    if '--sizes' in args:
+        index = args.index('--sizes')
+        sizes = [int(size) for size in args[index + 1].split(',')]
+        del args[index:index + 2]
+    timeout = None
+    if '--timeout' in args:
+        index = args.index('--timeout')
+        timeout = float(args[index + 1])
+        del args[index:index + 2]
+    runner = MeasurementRunner(root_dir, args, timeout)
     
     print("\n[1/3] Running all measurements...")
     results = runner.run_all_measurements()
+    if sizes:
+        runner.run_scaling_sweep(sizes)
     
     if results:
         print("\n[2/3] Generating plots...")
         runner.generate_plots()
+        runner.generate_scaling_plot()
         
         print("\n[3/3] Generating report...")
         runner.generate_report()
@@ -10,7 +10,7 @@ int main() {
     string newGroup = "NEW-GROUP-01";
 
     cout << "Before change:" << endl;
-    Student* student = students.search(emailToChange);
+    const Student* student = students.search(emailToChange);
     if (student) {
         student->print();
     }
@@ -37,21 +37,21 @@ int main() {
     cout << endl;
 
     cout << "=== 5. Radix Sort by birthday ===" << endl;
-    vector<Student> studentsVec = students.getAllStudents();
-
     cout << "Before sorting:" << endl;
-    for (size_t i = 0; i < min(size_t(5), studentsVec.size()); i++) {
-        studentsVec[i].print();
+    int shown = 0;
+    for (const Student& s : students) {
+        if (shown++ == 5) break;
+        s.print();
     }
 
-    radixSortByBirthday(studentsVec);
+    vector<const Student*> sorted = radixSortByBirthday(students);
 
     cout << "\nAfter Radix Sort (by month and day):" << endl;
-    for (size_t i = 0; i < min(size_t(5), studentsVec.size()); i++) {
-        studentsVec[i].print();
+    for (size_t i = 0; i < min(size_t(5), sorted.size()); i++) {
+        sorted[i]->print();
     }
 
-    saveToCSV(studentsVec, "students_sorted.csv");
+    saveToCSV(sorted, "students_sorted.csv");
 
     return 0;
 }
@@ -8,19 +8,31 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <type_traits>
+#include <unordered_map>
+#include "../../common/mapped_csv.h"
+#include "../../common/student_columns.h"
+#include "../../common/birthday_sort.h"
+#include "../../common/csv_writer.h"
+#include "../../common/inline_string.h"
+#include "../../common/object_arena.h"
 
 using namespace std;
 
+// Inline capacities cover the generated data, so a Student owns no heap memory
+using ShortString = InlineString<16>;
+using EmailString = InlineString<40>;
+
 struct Student {
-    string m_name;
-    string m_surname;
-    string m_email;
+    ShortString m_name;
+    ShortString m_surname;
+    EmailString m_email;
     int m_birth_year;
     int m_birth_month;
     int m_birth_day;
-    string m_group;
+    ShortString m_group;
     double m_rating;
-    string m_phone_number;
+    ShortString m_phone_number;
 
     void print() const {
         cout << m_name << " " << m_surname << " | " << m_group
@@ -38,37 +50,96 @@ struct GroupStats {
     }
 };
 
-// AVL Tree Node
+// AVL Tree Node, keyed by student.m_email.
+// count and ratingSum aggregate the whole subtree rooted at this node.
 struct AVLNode {
-    string email;
     Student student;
     AVLNode* left;
     AVLNode* right;
     int height;
+    int count;
+    double ratingSum;
+
+    explicit AVLNode(Student s)
+        : student(move(s)), left(nullptr), right(nullptr), height(1), count(1), ratingSum(student.m_rating) {}
 
-    AVLNode(const string& e, const Student& s)
-        : email(e), student(s), left(nullptr), right(nullptr), height(1) {}
+    string_view email() const {
+        return student.m_email;
+    }
 };
 
-// AVL Tree Class
+// AVL Tree Class. Nodes live in an arena: building the tree allocates one block
+// per 4096 students and destroying it frees the blocks without a traversal.
+// Subtree aggregates answer email-range queries in O(log n); per-group totals are
+// kept next to the tree, so group and rating changes must go through the tree.
 class AVLTree {
 private:
     AVLNode* root;
+    ObjectArena<AVLNode> nodes;
+    vector<pair<string, GroupStats>> groups;    // in order of first appearance
+    unordered_map<string, size_t> groupIndex;
 
     int getHeight(AVLNode* node) {
         return node ? node->height : 0;
     }
 
+    int getCount(AVLNode* node) {
+        return node ? node->count : 0;
+    }
+
+    double getRatingSum(AVLNode* node) {
+        return node ? node->ratingSum : 0.0;
+    }
+
     int getBalance(AVLNode* node) {
         return node ? getHeight(node->left) - getHeight(node->right) : 0;
     }
 
+    // Recomputes height and subtree aggregates from the children
     void updateHeight(AVLNode* node) {
         if (node) {
             node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+            node->count = 1 + getCount(node->left) + getCount(node->right);
+            node->ratingSum = node->student.m_rating + getRatingSum(node->left) + getRatingSum(node->right);
         }
     }
 
+    GroupStats& groupStats(string_view name) {
+        auto inserted = groupIndex.try_emplace(string(name), groups.size());
+        if (inserted.second) {
+            groups.push_back({inserted.first->first, GroupStats()});
+        }
+        return groups[inserted.first->second].second;
+    }
+
+    void addToGroup(const Student& student) {
+        GroupStats& stats = groupStats(student.m_group);
+        stats.studentCount++;
+        stats.totalRating += student.m_rating;
+    }
+
+    void removeFromGroup(const Student& student) {
+        GroupStats& stats = groupStats(student.m_group);
+        stats.studentCount--;
+        stats.totalRating -= student.m_rating;
+    }
+
+    // Count and rating sum of the students with email < key (or <= key if inclusive)
+    GroupStats aggregateBelow(string_view key, bool inclusive) {
+        GroupStats result;
+        AVLNode* node = root;
+        while (node) {
+            if (node->email() < key || (inclusive && node->email() == key)) {
+                result.studentCount += 1 + getCount(node->left);
+                result.totalRating += node->student.m_rating + getRatingSum(node->left);
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return result;
+    }
+
     AVLNode* rotateRight(AVLNode* y) {
         AVLNode* x = y->left;
         AVLNode* T2 = x->right;
@@ -95,17 +166,21 @@ private:
         return y;
     }
 
-    AVLNode* insert(AVLNode* node, const string& email, const Student& student) {
+    AVLNode* insert(AVLNode* node, string_view email, Student& student) {
         if (!node) {
-            return new AVLNode(email, student);
+            addToGroup(student);
+            return nodes.create(move(student));
         }
 
-        if (email < node->email) {
+        if (email < node->email()) {
             node->left = insert(node->left, email, student);
-        } else if (email > node->email) {
+        } else if (email > node->email()) {
             node->right = insert(node->right, email, student);
         } else {
-            node->student = student;
+            removeFromGroup(node->student);
+            addToGroup(student);
+            node->student = move(student);
+            updateHeight(node);
             return node;
         }
 
@@ -114,23 +189,23 @@ private:
         int balance = getBalance(node);
 
         // Left Left Case
-        if (balance > 1 && email < node->left->email) {
+        if (balance > 1 && email < node->left->email()) {
             return rotateRight(node);
         }
 
         // Right Right Case
-        if (balance < -1 && email > node->right->email) {
+        if (balance < -1 && email > node->right->email()) {
             return rotateLeft(node);
         }
 
         // Left Right Case
-        if (balance > 1 && email > node->left->email) {
+        if (balance > 1 && email > node->left->email()) {
             node->left = rotateLeft(node->left);
             return rotateRight(node);
         }
 
         // Right Left Case
-        if (balance < -1 && email < node->right->email) {
+        if (balance < -1 && email < node->right->email()) {
             node->right = rotateRight(node->right);
             return rotateLeft(node);
         }
@@ -138,57 +213,179 @@ private:
         return node;
     }
 
-    AVLNode* search(AVLNode* node, const string& email) {
-        if (!node || node->email == email) {
+    AVLNode* search(AVLNode* node, string_view email) {
+        if (!node || node->email() == email) {
             return node;
         }
 
-        if (email < node->email) {
+        if (email < node->email()) {
             return search(node->left, email);
         } else {
             return search(node->right, email);
         }
     }
 
-    void inorderTraversal(AVLNode* node, vector<Student>& students) {
-        if (!node) return;
+public:
+    // In-order (email order) iterator over const Student&. Keeps the path to the
+    // current node on an explicit stack (at most ~1.44 log2 n entries), no copies.
+    class const_iterator {
+    private:
+        vector<const AVLNode*> path;
+
+        void pushLeft(const AVLNode* node) {
+            while (node) {
+                path.push_back(node);
+                node = node->left;
+            }
+        }
 
-        inorderTraversal(node->left, students);
-        students.push_back(node->student);
-        inorderTraversal(node->right, students);
-    }
+    public:
+        const_iterator() = default;
 
-    void destroyTree(AVLNode* node) {
-        if (!node) return;
-        destroyTree(node->left);
-        destroyTree(node->right);
-        delete node;
-    }
+        explicit const_iterator(const AVLNode* root) {
+            pushLeft(root);
+        }
+
+        const Student& operator*() const {
+            return path.back()->student;
+        }
+
+        const Student* operator->() const {
+            return &path.back()->student;
+        }
+
+        const_iterator& operator++() {
+            const AVLNode* node = path.back();
+            path.pop_back();
+            pushLeft(node->right);
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            if (path.empty() || other.path.empty()) {
+                return path.empty() == other.path.empty();
+            }
+            return path.back() == other.path.back();
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
 
-public:
     AVLTree() : root(nullptr) {}
 
-    ~AVLTree() {
-        destroyTree(root);
+    AVLTree(AVLTree&& other) noexcept
+        : root(other.root), nodes(move(other.nodes)), groups(move(other.groups)),
+          groupIndex(move(other.groupIndex)) {
+        other.root = nullptr;
     }
 
-    void insert(const string& email, const Student& student) {
+    AVLTree& operator=(AVLTree&& other) noexcept {
+        if (this != &other) {
+            nodes = move(other.nodes);
+            groups = move(other.groups);
+            groupIndex = move(other.groupIndex);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
+    // Inserts or replaces the student stored under student.m_email
+    void insert(Student student) {
+        EmailString email = student.m_email;
         root = insert(root, email, student);
     }
 
-    Student* search(const string& email) {
+    const Student* search(string_view email) {
         AVLNode* node = search(root, email);
         return node ? &(node->student) : nullptr;
     }
 
-    vector<Student> getAllStudents() {
+    bool changeGroup(string_view email, const string& newGroup) {
+        AVLNode* node = search(root, email);
+        if (!node) {
+            return false;
+        }
+        removeFromGroup(node->student);
+        node->student.m_group = newGroup;
+        addToGroup(node->student);
+        return true;
+    }
+
+    // Students with lo <= email <= hi, in O(log n)
+    GroupStats rangeAggregate(string_view lo, string_view hi) {
+        if (hi < lo) return GroupStats();
+        GroupStats upTo = aggregateBelow(hi, true);
+        GroupStats below = aggregateBelow(lo, false);
+        upTo.studentCount -= below.studentCount;
+        upTo.totalRating -= below.totalRating;
+        return upTo;
+    }
+
+    // Per-group totals in order of first appearance; groups may be empty after moves
+    const vector<pair<string, GroupStats>>& getGroupStats() const {
+        return groups;
+    }
+
+    // O(G) over the group totals, no student traversal. Ties go to the earlier group.
+    const string* groupWithMostStudents(int& maxCount) const {
+        const string* maxGroup = nullptr;
+        maxCount = 0;
+        for (const auto& group : groups) {
+            if (group.second.studentCount > maxCount) {
+                maxCount = group.second.studentCount;
+                maxGroup = &group.first;
+            }
+        }
+        return maxGroup;
+    }
+
+    const string* groupWithHighestRating(double& maxAvgRating) const {
+        const string* bestGroup = nullptr;
+        maxAvgRating = 0.0;
+        for (const auto& group : groups) {
+            double avgRating = group.second.getAverageRating();
+            if (avgRating > maxAvgRating) {
+                maxAvgRating = avgRating;
+                bestGroup = &group.first;
+            }
+        }
+        return bestGroup;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(root);
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    // Calls fn(const Student&) in email order
+    template <class Fn>
+    void forEach(Fn&& fn) const {
+        for (const Student& student : *this) {
+            fn(student);
+        }
+    }
+
+    // Copies every student; prefer begin()/end() or forEach for read-only passes
+    vector<Student> getAllStudents() const {
         vector<Student> students;
-        inorderTraversal(root, students);
+        students.reserve(size());
+        for (const Student& student : *this) {
+            students.push_back(student);
+        }
         return students;
     }
 
-    int size() {
-        return getAllStudents().size();
+    int size() const {
+        return root ? root->count : 0;
     }
 };
 
@@ -230,7 +427,7 @@ AVLTree readCSVToAVL(const string& filename) {
             student.m_rating = stod(fields[7]);
             student.m_phone_number = fields[8];
 
-            tree.insert(student.m_email, student);
+            tree.insert(move(student));
         }
     }
 
@@ -238,138 +435,76 @@ AVLTree readCSVToAVL(const string& filename) {
     return tree;
 }
 
-bool changeGroupByEmail(AVLTree& tree, const string& email, const string& newGroup) {
-    Student* student = tree.search(email);
-    if (student) {
-        student->m_group = newGroup;
-        return true;
-    }
-    return false;
-}
+// Parses the file on `threads` workers (0 = all cores); inserts stay on the calling thread
+AVLTree readCSVToAVLParallel(const string& filename, unsigned threads = 0) {
+    AVLTree tree;
+    MappedFile file(filename);
 
-string findGroupWithMostStudents(AVLTree& tree) {
-    vector<Student> students = tree.getAllStudents();
-    vector<pair<string, int>> groupCount;
-
-    for (const auto& student : students) {
-        bool found = false;
-        for (auto& pair : groupCount) {
-            if (pair.first == student.m_group) {
-                pair.second++;
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            groupCount.push_back({student.m_group, 1});
-        }
+    if (!file.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return tree;
     }
 
-    string maxGroup;
-    int maxCount = 0;
+    vector<vector<Student>> chunks = parseCSVParallel<Student>(file, threads, makeStudent<Student>);
 
-    for (const auto& pair : groupCount) {
-        if (pair.second > maxCount) {
-            maxCount = pair.second;
-            maxGroup = pair.first;
+    for (auto& chunk : chunks) {
+        for (auto& student : chunk) {
+            tree.insert(move(student));
         }
     }
+    return tree;
+}
 
-    cout << "Group " << maxGroup << " has the most students: " << maxCount << endl;
-    return maxGroup;
+bool changeGroupByEmail(AVLTree& tree, const string& email, const string& newGroup) {
+    return tree.changeGroup(email, newGroup);
 }
 
-string findGroupWithHighestRating(AVLTree& tree) {
-    vector<Student> students = tree.getAllStudents();
-    vector<pair<string, GroupStats>> groupStats;
-
-    for (const auto& student : students) {
-        bool found = false;
-        for (auto& pair : groupStats) {
-            if (pair.first == student.m_group) {
-                pair.second.studentCount++;
-                pair.second.totalRating += student.m_rating;
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            GroupStats stats;
-            stats.studentCount = 1;
-            stats.totalRating = student.m_rating;
-            groupStats.push_back({student.m_group, stats});
-        }
-    }
+string findGroupWithMostStudents(AVLTree& tree) {
+    int maxCount;
+    const string* maxGroup = tree.groupWithMostStudents(maxCount);
+    string result = maxGroup ? *maxGroup : string();
 
-    string bestGroup;
-    double maxAvgRating = 0.0;
+    cout << "Group " << result << " has the most students: " << maxCount << endl;
+    return result;
+}
 
-    for (const auto& pair : groupStats) {
-        double avgRating = pair.second.getAverageRating();
-        if (avgRating > maxAvgRating) {
-            maxAvgRating = avgRating;
-            bestGroup = pair.first;
-        }
-    }
+string findGroupWithHighestRating(AVLTree& tree) {
+    double maxAvgRating;
+    const string* bestGroup = tree.groupWithHighestRating(maxAvgRating);
+    string result = bestGroup ? *bestGroup : string();
 
-    cout << "Group " << bestGroup << " has the highest average rating: "
+    cout << "Group " << result << " has the highest average rating: "
          << fixed << setprecision(2) << maxAvgRating << endl;
-    return bestGroup;
+    return result;
 }
 
-void radixSortByBirthday(vector<Student>& students) {
-    int n = students.size();
-    if (n == 0) return;
-
-    {
-        vector<vector<Student>> buckets(32);
-
-        for (const auto& student : students) {
-            buckets[student.m_birth_day].push_back(student);
-        }
-
-        int index = 0;
-        for (int i = 1; i <= 31; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
+StudentColumns toColumns(AVLTree& tree) {
+    StudentColumns columns;
+    columns.reserve(tree.size());
+    for (const Student& student : tree) {
+        columns.add(student);
     }
+    return columns;
+}
 
-    {
-        vector<vector<Student>> buckets(13);
-
-        for (const auto& student : students) {
-            buckets[student.m_birth_month].push_back(student);
-        }
-
-        int index = 0;
-        for (int i = 1; i <= 12; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
-    }
+void radixSortByBirthday(vector<Student>& students) {
+    sortByBirthday(students);
 }
 
-void saveToCSV(const vector<Student>& students, const string& filename) {
-    ofstream file(filename);
+// Students of the tree ordered by (month, day), email order within a day.
+// One pass over the tree, no Student copies.
+vector<const Student*> radixSortByBirthday(const AVLTree& tree) {
+    return sortedByBirthday<Student>(tree, tree.size());
+}
 
-    if (!file.is_open()) {
+// Works for vector<Student> and for the vector<const Student*> of radixSortByBirthday(tree);
+// threads > 1 formats and writes parallel chunks (see writeStudentsCSV)
+template <class Item>
+void saveToCSV(const vector<Item>& students, const string& filename, unsigned threads = 1) {
+    if (!writeStudentsCSV(students, filename, threads)) {
         cerr << "Error creating file!" << endl;
         return;
     }
-
-    file << "m_name,m_surname,m_email,m_birth_year,m_birth_month,m_birth_day,m_group,m_rating,m_phone_number\n";
-
-    for (const auto& s : students) {
-        file << s.m_name << "," << s.m_surname << "," << s.m_email << ","
-             << s.m_birth_year << "," << s.m_birth_month << "," << s.m_birth_day << ","
-             << s.m_group << "," << fixed << setprecision(2) << s.m_rating << ","
-             << s.m_phone_number << "\n";
-    }
-
-    file.close();
     cout << "\nFile saved: " << filename << endl;
 }
 
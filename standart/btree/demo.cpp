@@ -0,0 +1,57 @@
+#include "student_manager.h"
+
+int main() {
+    cout << "=== 1. Creating B+-tree ===" << endl;
+    BTree students = readCSVToBTree("students.csv");
+    cout << "Students loaded: " << students.size() << endl << endl;
+
+    cout << "=== 2. Changing student group ===" << endl;
+    string emailToChange = "ivan.kravchenko@student.org";
+    string newGroup = "NEW-GROUP-01";
+
+    cout << "Before change:" << endl;
+    const Student* student = students.search(emailToChange);
+    if (student) {
+        student->print();
+    }
+
+    if (changeGroupByEmail(students, emailToChange, newGroup)) {
+        cout << "After change:" << endl;
+        student = students.search(emailToChange);
+        if (student) {
+            student->print();
+        }
+    } else {
+        cout << "Student not found!" << endl;
+    }
+    cout << endl;
+
+    changeGroupByEmail(students, emailToChange, "NXE-49");
+
+    cout << "=== 3. Group with most students ===" << endl;
+    findGroupWithMostStudents(students);
+    cout << endl;
+
+    cout << "=== 4. Group with highest average rating ===" << endl;
+    findGroupWithHighestRating(students);
+    cout << endl;
+
+    cout << "=== 5. Radix Sort by birthday ===" << endl;
+    cout << "Before sorting:" << endl;
+    int shown = 0;
+    for (const Student& s : students) {
+        if (shown++ == 5) break;
+        s.print();
+    }
+
+    vector<const Student*> sorted = radixSortByBirthday(students);
+
+    cout << "\nAfter Radix Sort (by month and day):" << endl;
+    for (size_t i = 0; i < min(size_t(5), sorted.size()); i++) {
+        sorted[i]->print();
+    }
+
+    saveToCSV(sorted, "students_sorted.csv");
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "student_manager.h"
+#include "../../common/benchmark.h"
+
+class BTreeBackend {
+private:
+    BTree students;
+    vector<string> emails;
+    vector<string> groups;
+
+public:
+    static constexpr const char* kName = "B+ Tree";
+    static constexpr const char* kDescription = "with per-group totals";
+
+    bool load(const string& dataset) {
+        students = readCSVToBTreeParallel(dataset);
+        for (const Student& student : students) {
+            emails.push_back(student.m_email);
+        }
+        for (const auto& pair : students.getGroupStats()) {
+            groups.push_back(pair.first);
+        }
+        sortKeys(emails);
+        sortKeys(groups);
+        return students.size() > 0;
+    }
+
+    size_t size() const { return students.size(); }
+    size_t emailCount() const { return emails.size(); }
+    size_t groupCount() const { return groups.size(); }
+
+    void mostStudents() {
+        int maxCount;
+        students.groupWithMostStudents(maxCount);
+    }
+
+    void changeGroup(size_t email, size_t group) {
+        changeGroupByEmail(students, emails[email], groups[group]);
+    }
+
+    void highestRating() {
+        double maxAvgRating;
+        students.groupWithHighestRating(maxAvgRating);
+    }
+
+    string mostStudentsGroup() {
+        int maxCount;
+        const string* group = students.groupWithMostStudents(maxCount);
+        return group ? *group : string();
+    }
+
+    string highestRatingGroup() {
+        double maxAvgRating;
+        const string* group = students.groupWithHighestRating(maxAvgRating);
+        return group ? *group : string();
+    }
+
+    bool lookup(size_t email) {
+        return students.search(emails[email]) != nullptr;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    BTreeBackend backend;
+    return benchmarkMain(backend, argc, argv);
+}
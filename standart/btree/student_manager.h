@@ -0,0 +1,585 @@
+#ifndef STUDENT_MANAGER_H
+#define STUDENT_MANAGER_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include "../../common/mapped_csv.h"
+#include "../../common/student_columns.h"
+#include "../../common/birthday_sort.h"
+#include "../../common/csv_writer.h"
+#include "../../common/inline_string.h"
+#include "../../common/object_arena.h"
+
+using namespace std;
+
+// Inline capacities cover the generated data, so a Student owns no heap memory
+using ShortString = InlineString<16>;
+using EmailString = InlineString<40>;
+
+struct Student {
+    ShortString m_name;
+    ShortString m_surname;
+    EmailString m_email;
+    int m_birth_year;
+    int m_birth_month;
+    int m_birth_day;
+    ShortString m_group;
+    double m_rating;
+    ShortString m_phone_number;
+
+    void print() const {
+        cout << m_name << " " << m_surname << " | " << m_group
+             << " | " << m_birth_day << "." << m_birth_month
+             << " | Rating: " << m_rating << endl;
+    }
+};
+
+struct GroupStats {
+    int studentCount = 0;
+    double totalRating = 0.0;
+
+    double getAverageRating() const {
+        return studentCount > 0 ? totalRating / studentCount : 0.0;
+    }
+};
+
+// 8 bytes of a key starting at `offset`, big-endian and zero padded: comparing slices
+// as integers orders keys that share the first `offset` bytes, as long as slices differ
+uint64_t keySlice(string_view key, size_t offset) {
+    uint64_t slice = 0;
+    size_t n = offset < key.size() ? min<size_t>(key.size() - offset, 8) : 0;
+    for (size_t i = 0; i < n; i++) {
+        slice |= uint64_t(static_cast<unsigned char>(key[offset + i])) << (56 - 8 * i);
+    }
+    return slice;
+}
+
+// B+-tree nodes are 256 bytes (4 cache lines). Each node stores the prefix shared by
+// all of its keys (up to kMaxSkip bytes) and, per key, the 8 bytes that follow it plus
+// the record index of the full key. Emails share long prefixes ("ivan.kravchenko..."),
+// so plain leading bytes would almost always tie; after truncation a node search scans
+// one or two lines of slices and reads a record only when slices tie.
+constexpr int kLeafKeys = 16;
+constexpr int kInnerKeys = 10;
+constexpr int kMaxSkip = 24;
+
+struct alignas(64) BTreeLeaf {
+    uint64_t slices[kLeafKeys];
+    uint32_t records[kLeafKeys];
+    int count = 0;
+    uint8_t skip = 0;            // length of common
+    char common[kMaxSkip];
+    BTreeLeaf* next = nullptr;
+};
+
+// children[i] holds keys < key i; children[i + 1] holds keys >= key i
+struct alignas(64) BTreeInner {
+    uint64_t slices[kInnerKeys];
+    uint32_t records[kInnerKeys];
+    void* children[kInnerKeys + 1];
+    int count = 0;
+    uint8_t skip = 0;
+    char common[kMaxSkip];
+};
+
+static_assert(sizeof(BTreeLeaf) == 256, "leaf should span 4 cache lines");
+static_assert(sizeof(BTreeInner) == 256, "inner node should span 4 cache lines");
+
+// Ordered email index over a contiguous vector of students. Nodes come from
+// arenas; keys are never removed (a group change does not move a key).
+// Per-group totals are kept next to the tree like in the AVL backend, so group
+// changes must go through the tree.
+class BTree {
+private:
+    vector<Student> students;
+    ObjectArena<BTreeLeaf, 1024> leaves;
+    ObjectArena<BTreeInner, 256> inners;
+    void* root = nullptr;
+    int height = 0;                                // 0 = empty, 1 = root is a leaf
+    vector<pair<string, GroupStats>> groups;       // in order of first appearance
+    unordered_map<string, size_t> groupIndex;
+
+    string_view keyOf(uint32_t record) const {
+        return students[record].m_email.view();
+    }
+
+    // Compares key with the node's common prefix: <0 if key sorts before every key
+    // of the node, >0 if after every key, 0 if it shares the prefix
+    template <class Node>
+    static int comparePrefix(const Node* node, string_view key) {
+        size_t n = min<size_t>(key.size(), node->skip);
+        int result = memcmp(key.data(), node->common, n);
+        if (result != 0) return result;
+        return key.size() < node->skip ? -1 : 0;
+    }
+
+    // Number of keys in the node that are < key (orEqual: <= key)
+    template <class Node>
+    int countBelow(const Node* node, string_view key, bool orEqual) const {
+        int side = comparePrefix(node, key);
+        if (side != 0) {
+            return side < 0 ? 0 : node->count;
+        }
+
+        uint64_t slice = keySlice(key, node->skip);
+        int i = 0;
+        while (i < node->count && node->slices[i] < slice) {
+            i++;
+        }
+        while (i < node->count && node->slices[i] == slice) {
+            int result = key.compare(keyOf(node->records[i]));
+            if (result < 0 || (result == 0 && !orEqual)) break;
+            i++;
+        }
+        return i;
+    }
+
+    // First position whose key is >= key
+    template <class Node>
+    int lowerBound(const Node* node, string_view key) const {
+        return countBelow(node, key, false);
+    }
+
+    // Child that may contain key: number of separators <= key
+    int childIndex(const BTreeInner* node, string_view key) const {
+        return countBelow(node, key, true);
+    }
+
+    // Keys are sorted, so the prefix shared by all of them is the one of the first and last
+    template <class Node>
+    void rebuildPrefix(Node* node) {
+        size_t skip = 0;
+        if (node->count > 0) {
+            string_view first = keyOf(node->records[0]);
+            string_view last = keyOf(node->records[node->count - 1]);
+            size_t limit = min({first.size(), last.size(), size_t(kMaxSkip)});
+            while (skip < limit && first[skip] == last[skip]) {
+                skip++;
+            }
+            memcpy(node->common, first.data(), skip);
+        }
+        node->skip = static_cast<uint8_t>(skip);
+        for (int i = 0; i < node->count; i++) {
+            node->slices[i] = keySlice(keyOf(node->records[i]), skip);
+        }
+    }
+
+    const BTreeLeaf* findLeaf(string_view key) const {
+        const void* node = root;
+        for (int level = height; level > 1; level--) {
+            const BTreeInner* inner = static_cast<const BTreeInner*>(node);
+            node = inner->children[childIndex(inner, key)];
+        }
+        return static_cast<const BTreeLeaf*>(node);
+    }
+
+    const BTreeLeaf* leftmostLeaf() const {
+        const void* node = root;
+        for (int level = height; level > 1; level--) {
+            node = static_cast<const BTreeInner*>(node)->children[0];
+        }
+        return static_cast<const BTreeLeaf*>(node);
+    }
+
+    GroupStats& groupStats(string_view name) {
+        auto inserted = groupIndex.try_emplace(string(name), groups.size());
+        if (inserted.second) {
+            groups.push_back({inserted.first->first, GroupStats()});
+        }
+        return groups[inserted.first->second].second;
+    }
+
+    void addToGroup(const Student& student) {
+        GroupStats& stats = groupStats(student.m_group);
+        stats.studentCount++;
+        stats.totalRating += student.m_rating;
+    }
+
+    void removeFromGroup(const Student& student) {
+        GroupStats& stats = groupStats(student.m_group);
+        stats.studentCount--;
+        stats.totalRating -= student.m_rating;
+    }
+
+    struct Split {
+        void* right = nullptr;   // new right sibling, nullptr if the child did not split
+        uint32_t record = 0;     // first key of right
+    };
+
+    // A key outside the common prefix shortens it, which re-slices the whole node
+    template <class Node>
+    void insertAt(Node* node, int pos, uint32_t record) {
+        for (int i = node->count; i > pos; i--) {
+            node->slices[i] = node->slices[i - 1];
+            node->records[i] = node->records[i - 1];
+        }
+        node->records[pos] = record;
+        node->count++;
+
+        string_view key = keyOf(record);
+        if (comparePrefix(node, key) == 0) {
+            node->slices[pos] = keySlice(key, node->skip);
+        } else {
+            rebuildPrefix(node);
+        }
+    }
+
+    template <class Node>
+    static void moveUpperHalf(Node* from, Node* to, int first) {
+        for (int i = first; i < from->count; i++) {
+            to->records[i - first] = from->records[i];
+        }
+        to->count = from->count - first;
+    }
+
+    Split insertIntoLeaf(BTreeLeaf* leaf, string_view key, Student& student) {
+        int pos = lowerBound(leaf, key);
+        if (pos < leaf->count && key == keyOf(leaf->records[pos])) {
+            Student& existing = students[leaf->records[pos]];
+            removeFromGroup(existing);
+            addToGroup(student);
+            existing = move(student);
+            return Split();
+        }
+
+        uint32_t record = static_cast<uint32_t>(students.size());
+        addToGroup(student);
+        students.push_back(move(student));
+
+        if (leaf->count < kLeafKeys) {
+            insertAt(leaf, pos, record);
+            return Split();
+        }
+
+        BTreeLeaf* right = leaves.create();
+        int half = kLeafKeys / 2;
+        moveUpperHalf(leaf, right, half);
+        leaf->count = half;
+        right->next = leaf->next;
+        leaf->next = right;
+        rebuildPrefix(leaf);
+        rebuildPrefix(right);
+
+        if (pos <= half) {
+            insertAt(leaf, pos, record);
+        } else {
+            insertAt(right, pos - half, record);
+        }
+        return Split{right, right->records[0]};
+    }
+
+    Split insert(void* node, int level, string_view key, Student& student) {
+        if (level == 1) {
+            return insertIntoLeaf(static_cast<BTreeLeaf*>(node), key, student);
+        }
+
+        BTreeInner* inner = static_cast<BTreeInner*>(node);
+        int child = childIndex(inner, key);
+        Split split = insert(inner->children[child], level - 1, key, student);
+        if (!split.right) {
+            return Split();
+        }
+
+        if (inner->count < kInnerKeys) {
+            insertSeparator(inner, child, split);
+            return Split();
+        }
+
+        // Full: split around the middle separator, which moves up
+        BTreeInner* right = inners.create();
+        int half = kInnerKeys / 2;
+        Split up{right, inner->records[half]};
+        moveUpperHalf(inner, right, half + 1);
+        for (int i = half + 1; i <= kInnerKeys; i++) {
+            right->children[i - half - 1] = inner->children[i];
+        }
+        inner->count = half;
+        rebuildPrefix(inner);
+        rebuildPrefix(right);
+
+        if (child <= half) {
+            insertSeparator(inner, child, split);
+        } else {
+            insertSeparator(right, child - half - 1, split);
+        }
+        return up;
+    }
+
+    // split.right becomes the child after position `child`
+    void insertSeparator(BTreeInner* node, int child, const Split& split) {
+        for (int i = node->count + 1; i > child + 1; i--) {
+            node->children[i] = node->children[i - 1];
+        }
+        node->children[child + 1] = split.right;
+        insertAt(node, child, split.record);
+    }
+
+public:
+    // In-order (email order) iterator over const Student&, following the leaf chain
+    class const_iterator {
+    private:
+        const BTree* tree = nullptr;
+        const BTreeLeaf* leaf = nullptr;
+        int pos = 0;
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(const BTree* t, const BTreeLeaf* l) : tree(t), leaf(l) {
+            if (leaf && leaf->count == 0) leaf = nullptr;
+        }
+
+        const Student& operator*() const {
+            return tree->students[leaf->records[pos]];
+        }
+
+        const Student* operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            if (++pos == leaf->count) {
+                leaf = leaf->next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return leaf == other.leaf && pos == other.pos;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    BTree() = default;
+
+    BTree(BTree&& other) noexcept
+        : students(move(other.students)), leaves(move(other.leaves)), inners(move(other.inners)),
+          root(other.root), height(other.height), groups(move(other.groups)),
+          groupIndex(move(other.groupIndex)) {
+        other.root = nullptr;
+        other.height = 0;
+    }
+
+    BTree& operator=(BTree&& other) noexcept {
+        if (this != &other) {
+            students = move(other.students);
+            leaves = move(other.leaves);
+            inners = move(other.inners);
+            groups = move(other.groups);
+            groupIndex = move(other.groupIndex);
+            root = other.root;
+            height = other.height;
+            other.root = nullptr;
+            other.height = 0;
+        }
+        return *this;
+    }
+
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+
+    void reserve(size_t count) {
+        students.reserve(count);
+    }
+
+    // Inserts or replaces the student stored under student.m_email
+    void insert(Student student) {
+        EmailString email = student.m_email;
+        if (!root) {
+            root = leaves.create();
+            height = 1;
+        }
+
+        Split split = insert(root, height, email, student);
+        if (split.right) {
+            BTreeInner* newRoot = inners.create();
+            newRoot->children[0] = root;
+            insertSeparator(newRoot, 0, split);
+            root = newRoot;
+            height++;
+        }
+    }
+
+    const Student* search(string_view email) const {
+        if (!root) return nullptr;
+        const BTreeLeaf* leaf = findLeaf(email);
+        int pos = lowerBound(leaf, email);
+        if (pos < leaf->count && email == keyOf(leaf->records[pos])) {
+            return &students[leaf->records[pos]];
+        }
+        return nullptr;
+    }
+
+    bool changeGroup(string_view email, const string& newGroup) {
+        const Student* found = search(email);
+        if (!found) {
+            return false;
+        }
+        Student& student = students[found - students.data()];
+        removeFromGroup(student);
+        student.m_group = newGroup;
+        addToGroup(student);
+        return true;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, root ? leftmostLeaf() : nullptr);
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    int size() const {
+        return students.size();
+    }
+
+    int getHeight() const {
+        return height;
+    }
+
+    // Per-group totals in order of first appearance; groups may be empty after moves
+    const vector<pair<string, GroupStats>>& getGroupStats() const {
+        return groups;
+    }
+
+    // O(G) over the group totals, no student traversal. Ties go to the earlier group.
+    const string* groupWithMostStudents(int& maxCount) const {
+        const string* maxGroup = nullptr;
+        maxCount = 0;
+        for (const auto& group : groups) {
+            if (group.second.studentCount > maxCount) {
+                maxCount = group.second.studentCount;
+                maxGroup = &group.first;
+            }
+        }
+        return maxGroup;
+    }
+
+    const string* groupWithHighestRating(double& maxAvgRating) const {
+        const string* bestGroup = nullptr;
+        maxAvgRating = 0.0;
+        for (const auto& group : groups) {
+            double avgRating = group.second.getAverageRating();
+            if (avgRating > maxAvgRating) {
+                maxAvgRating = avgRating;
+                bestGroup = &group.first;
+            }
+        }
+        return bestGroup;
+    }
+};
+
+BTree readCSVToBTree(const string& filename) {
+    BTree tree;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return tree;
+    }
+
+    const char* begin = skipCSVHeader(file.begin(), file.end());
+    tree.reserve(countLines(begin, file.end()));
+
+    StudentRow row;
+    forEachLine(begin, file.end(), [&](string_view line) {
+        if (parseStudentRow(line, row)) {
+            tree.insert(makeStudent<Student>(row));
+        }
+    });
+    return tree;
+}
+
+// Parses the file on `threads` workers (0 = all cores); inserts stay on the calling thread
+BTree readCSVToBTreeParallel(const string& filename, unsigned threads = 0) {
+    BTree tree;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return tree;
+    }
+
+    vector<vector<Student>> chunks = parseCSVParallel<Student>(file, threads, makeStudent<Student>);
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.size();
+    }
+    tree.reserve(total);
+
+    for (auto& chunk : chunks) {
+        for (auto& student : chunk) {
+            tree.insert(move(student));
+        }
+    }
+    return tree;
+}
+
+bool changeGroupByEmail(BTree& tree, const string& email, const string& newGroup) {
+    return tree.changeGroup(email, newGroup);
+}
+
+string findGroupWithMostStudents(BTree& tree) {
+    int maxCount;
+    const string* maxGroup = tree.groupWithMostStudents(maxCount);
+    string result = maxGroup ? *maxGroup : string();
+
+    cout << "Group " << result << " has the most students: " << maxCount << endl;
+    return result;
+}
+
+string findGroupWithHighestRating(BTree& tree) {
+    double maxAvgRating;
+    const string* bestGroup = tree.groupWithHighestRating(maxAvgRating);
+    string result = bestGroup ? *bestGroup : string();
+
+    cout << "Group " << result << " has the highest average rating: "
+         << fixed << setprecision(2) << maxAvgRating << endl;
+    return result;
+}
+
+StudentColumns toColumns(BTree& tree) {
+    StudentColumns columns;
+    columns.reserve(tree.size());
+    for (const Student& student : tree) {
+        columns.add(student);
+    }
+    return columns;
+}
+
+// Students of the tree ordered by (month, day), email order within a day.
+// One pass over the tree, no Student copies.
+vector<const Student*> radixSortByBirthday(const BTree& tree) {
+    return sortedByBirthday<Student>(tree, tree.size());
+}
+
+void radixSortByBirthday(vector<Student>& students) {
+    sortByBirthday(students);
+}
+
+// Works for vector<Student> and for the vector<const Student*> of radixSortByBirthday(tree);
+// threads > 1 formats and writes parallel chunks (see writeStudentsCSV)
+template <class Item>
+void saveToCSV(const vector<Item>& students, const string& filename, unsigned threads = 1) {
+    if (!writeStudentsCSV(students, filename, threads)) {
+        cerr << "Error creating file!" << endl;
+        return;
+    }
+    cout << "\nFile saved: " << filename << endl;
+}
+
+#endif // STUDENT_MANAGER_H
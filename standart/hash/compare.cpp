@@ -1,41 +1,121 @@
 #include "student_manager.h"
 #include <chrono>
+#include <sstream>
 
-int main() {
+vector<size_t> parseList(const string& list) {
+    vector<size_t> values;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(stoul(item));
+    }
+    return values;
+}
+
+// Runs sortFn on a copy of input, returns records/sec and leaves the result in output
+template <class SortFn>
+double timeSort(const vector<Student>& input, vector<Student>& output, SortFn&& sortFn) {
+    output = input;
+    auto start = chrono::high_resolution_clock::now();
+    sortFn(output);
+    auto end = chrono::high_resolution_clock::now();
+    chrono::duration<double> elapsed = end - start;
+    return input.size() / elapsed.count();
+}
+
+bool sameBirthdays(const vector<Student>& a, const vector<Student>& b) {
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].m_birth_month != b[i].m_birth_month ||
+            a[i].m_birth_day != b[i].m_birth_day) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Usage: ./compare [--sizes 100000,1000000] [--threads 1,2,4,8] [--export sorted.csv]
+// Inputs larger than the roster repeat it. --export also times saveToCSV of each sorted input.
+int main(int argc, char* argv[]) {
     string filename = "students.csv";
+    vector<size_t> sizes;
+    vector<size_t> threadCounts;
+    string exportFile;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--sizes") {
+            sizes = parseList(argv[i + 1]);
+        } else if (arg == "--threads") {
+            threadCounts = parseList(argv[i + 1]);
+        } else if (arg == "--export") {
+            exportFile = argv[i + 1];
+        }
+    }
+
     unordered_map<string, Student> studentMap = readCSVToHashTable(filename);
 
     // to vector
-    vector<Student> students1, students2;
+    vector<Student> roster;
     for (const auto& pair : studentMap) {
-        students1.push_back(pair.second);
+        roster.push_back(pair.second);
+    }
+    if (roster.empty()) {
+        cerr << "No data loaded!" << endl;
+        return 1;
     }
-    students2 = students1;
 
-    // Radix Sort
-    auto start = chrono::high_resolution_clock::now();
-    radixSort(students1);
-    auto end = chrono::high_resolution_clock::now();
-    chrono::duration<double> elapsedRadix = end - start;
-    cout << "Radix Sort elapsed time: " << elapsedRadix.count() << " s" << endl;
-
-    // Quick Sort
-    start = chrono::high_resolution_clock::now();
-    quickSort(students2, 0, students2.size() - 1);
-    end = chrono::high_resolution_clock::now();
-    chrono::duration<double> elapsedQuick = end - start;
-    cout << "Quick Sort elapsed time: " << elapsedQuick.count() << " s" << endl;
-
-    // correctness check
-    bool same = true;
-    for (size_t i = 0; i < students1.size(); i++) {
-        if (students1[i].m_birth_month != students2[i].m_birth_month ||
-            students1[i].m_birth_day != students2[i].m_birth_day) {
-            same = false;
-            break;
+    if (sizes.empty()) {
+        sizes = {roster.size() / 10, roster.size(), roster.size() * 5};
+    }
+    if (threadCounts.empty()) {
+        for (size_t t = 1; t <= defaultThreadCount(); t *= 2) {
+            threadCounts.push_back(t);
+        }
+        if (threadCounts.back() != defaultThreadCount()) {
+            threadCounts.push_back(defaultThreadCount());
+        }
+    }
+
+    cout << fixed << setprecision(0);
+    for (size_t size : sizes) {
+        vector<Student> input;
+        input.reserve(size);
+        for (size_t i = 0; i < size; i++) {
+            input.push_back(roster[i % roster.size()]);
+        }
+
+        vector<Student> radixSorted, other;
+        double radixRate = timeSort(input, radixSorted, [](vector<Student>& s) { radixSort(s); });
+        cout << "Records: " << size << " | Radix Sort | Threads: 1 | Records/sec: " << radixRate << endl;
+
+        for (size_t threads : threadCounts) {
+            double rate = timeSort(input, other, [&](vector<Student>& s) { sortByBirthdayParallel(s, threads); });
+            bool same = true;
+            for (size_t i = 0; i < size && same; i++) {
+                same = other[i].m_email == radixSorted[i].m_email;
+            }
+            cout << "Records: " << size << " | Parallel Radix Sort | Threads: " << threads
+                 << " | Records/sec: " << rate << " | Speedup: " << setprecision(2) << rate / radixRate
+                 << setprecision(0) << " | " << (same ? "identical" : "different") << endl;
+        }
+
+        double quickRate = timeSort(input, other, [](vector<Student>& s) { quickSort(s, 0, s.size() - 1); });
+        cout << "Records: " << size << " | Quick Sort | Threads: 1 | Records/sec: " << quickRate
+             << " | " << (sameBirthdays(other, radixSorted) ? "identical" : "different") << endl;
+
+        for (size_t threads : exportFile.empty() ? vector<size_t>() : threadCounts) {
+            auto start = chrono::high_resolution_clock::now();
+            if (!writeStudentsCSV(radixSorted, exportFile, threads)) {
+                cerr << "Error creating file!" << endl;
+                return 1;
             }
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+            double megabytes = MappedFile(exportFile).size() / (1024.0 * 1024.0);
+            cout << "Records: " << size << " | CSV Export | Threads: " << threads << " | Records/sec: "
+                 << size / elapsed.count() << " | MB/s: " << megabytes / elapsed.count() << endl;
+        }
+        cout << endl;
     }
-    cout << "Sorting results are " << (same ? "identical" : "different") << endl;
 
     return 0;
 }
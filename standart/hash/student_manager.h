@@ -10,6 +10,10 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include "../../common/mapped_csv.h"
+#include "../../common/student_columns.h"
+#include "../../common/birthday_sort.h"
+#include "../../common/csv_writer.h"
 
 using namespace std;
 
@@ -86,6 +90,33 @@ unordered_map<string, Student> readCSVToHashTable(const string& filename) {
     return hashTable;
 }
 
+// Parses the file on `threads` workers (0 = all cores), then merges the chunks in file order
+unordered_map<string, Student> readCSVToHashTableParallel(const string& filename, unsigned threads = 0) {
+    unordered_map<string, Student> hashTable;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return hashTable;
+    }
+
+    vector<vector<Student>> chunks = parseCSVParallel<Student>(file, threads, makeStudent<Student>);
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.size();
+    }
+    hashTable.reserve(total);
+
+    for (auto& chunk : chunks) {
+        for (auto& student : chunk) {
+            string email = student.m_email;
+            hashTable[move(email)] = move(student);
+        }
+    }
+    return hashTable;
+}
+
 bool changeGroupByEmail(unordered_map<string, Student>& students,
                         const string& email, const string& newGroup) {
     auto it = students.find(email);
@@ -96,7 +127,8 @@ bool changeGroupByEmail(unordered_map<string, Student>& students,
     return false;
 }
 
-string findGroupWithMostStudents(const unordered_map<string, Student>& students) {
+// Op1 without printing
+string groupWithMostStudents(const unordered_map<string, Student>& students, int& maxCount) {
     unordered_map<string, int> groupCount;
 
     for (const auto& pair : students) {
@@ -104,7 +136,7 @@ string findGroupWithMostStudents(const unordered_map<string, Student>& students)
     }
 
     string maxGroup;
-    int maxCount = 0;
+    maxCount = 0;
 
     for (const auto& pair : groupCount) {
         if (pair.second > maxCount) {
@@ -113,11 +145,19 @@ string findGroupWithMostStudents(const unordered_map<string, Student>& students)
         }
     }
 
+    return maxGroup;
+}
+
+string findGroupWithMostStudents(const unordered_map<string, Student>& students) {
+    int maxCount;
+    string maxGroup = groupWithMostStudents(students, maxCount);
+
     cout << "Group " << maxGroup << " has the most students: " << maxCount << endl;
     return maxGroup;
 }
 
-string findGroupWithHighestRating(const unordered_map<string, Student>& students) {
+// Op3 without printing
+string groupWithHighestRating(const unordered_map<string, Student>& students, double& maxAvgRating) {
     unordered_map<string, GroupStats> groupStats;
 
     for (const auto& pair : students) {
@@ -127,7 +167,7 @@ string findGroupWithHighestRating(const unordered_map<string, Student>& students
     }
 
     string bestGroup;
-    double maxAvgRating = 0.0;
+    maxAvgRating = 0.0;
 
     for (const auto& pair : groupStats) {
         double avgRating = pair.second.getAverageRating();
@@ -137,66 +177,43 @@ string findGroupWithHighestRating(const unordered_map<string, Student>& students
         }
     }
 
-    cout << "Group " << bestGroup << " has the highest average rating: "
-         << fixed << setprecision(2) << maxAvgRating << endl;
     return bestGroup;
 }
 
-void radixSort(vector<Student>& students) {
-    int n = students.size();
-    if (n == 0) return;
-
-    vector<Student> temp(n);
-
-    {
-        vector<vector<Student>> buckets(32);
+string findGroupWithHighestRating(const unordered_map<string, Student>& students) {
+    double maxAvgRating;
+    string bestGroup = groupWithHighestRating(students, maxAvgRating);
 
-        for (const auto& student : students) {
-            buckets[student.m_birth_day].push_back(student);
-        }
+    cout << "Group " << bestGroup << " has the highest average rating: "
+         << fixed << setprecision(2) << maxAvgRating << endl;
+    return bestGroup;
+}
 
-        int index = 0;
-        for (int i = 1; i <= 31; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
+StudentColumns toColumns(const unordered_map<string, Student>& students) {
+    StudentColumns columns;
+    columns.reserve(students.size());
+    for (const auto& pair : students) {
+        columns.add(pair.second);
     }
+    return columns;
+}
 
-    {
-        vector<vector<Student>> buckets(13);
-
-        for (const auto& student : students) {
-            buckets[student.m_birth_month].push_back(student);
-        }
-
-        int index = 0;
-        for (int i = 1; i <= 12; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
-    }
+// Counting sort on the packed (month, day) key; see common/birthday_sort.h
+void radixSort(vector<Student>& students) {
+    sortByBirthday(students);
 }
 
-void saveToCSV(const vector<Student>& students, const string& filename) {
-    ofstream file(filename);
+// Same name as in the other backends
+void radixSortByBirthday(vector<Student>& students) {
+    sortByBirthday(students);
+}
 
-    if (!file.is_open()) {
+// threads > 1 formats and writes parallel chunks (see writeStudentsCSV)
+void saveToCSV(const vector<Student>& students, const string& filename, unsigned threads = 1) {
+    if (!writeStudentsCSV(students, filename, threads)) {
         cerr << "Error creating file!" << endl;
         return;
     }
-
-    file << "m_name,m_surname,m_email,m_birth_year,m_birth_month,m_birth_day,m_group,m_rating,m_phone_number\n";
-
-    for (const auto& s : students) {
-        file << s.m_name << "," << s.m_surname << "," << s.m_email << ","
-             << s.m_birth_year << "," << s.m_birth_month << "," << s.m_birth_day << ","
-             << s.m_group << "," << fixed << setprecision(2) << s.m_rating << ","
-             << s.m_phone_number << "\n";
-    }
-
-    file.close();
     cout << "\nFile saved: " << filename << endl;
 }
 
@@ -207,26 +224,55 @@ bool compare(const Student& a, const Student& b) {
     return a.m_birth_month < b.m_birth_month;
 }
 
-int partition(vector<Student>& students, int low, int high) {
-    Student pivot = students[high];
-    int i = low - 1;
+// Introsort on (month, day): median-of-three pivot and 3-way partition, so runs of equal
+// birthdays (only 366 distinct keys) are finished in one pass instead of degrading to
+// O(n^2). Recurses into the smaller side and loops on the larger one (O(log n) stack),
+// and switches to heapsort past 2*log2(n) levels. Every step compares the clamped
+// birthdayKey, so out-of-range dates land where sortByBirthday puts them.
+void quickSort(vector<Student>& students, int low, int high, int depthLimit) {
+    auto byKey = [](const Student& a, const Student& b) { return birthdayKey(a) < birthdayKey(b); };
+    while (low < high) {
+        if (depthLimit-- == 0) {
+            make_heap(students.begin() + low, students.begin() + high + 1, byKey);
+            sort_heap(students.begin() + low, students.begin() + high + 1, byKey);
+            return;
+        }
+
+        int mid = low + (high - low) / 2;
+        if (byKey(students[mid], students[low])) swap(students[mid], students[low]);
+        if (byKey(students[high], students[low])) swap(students[high], students[low]);
+        if (byKey(students[high], students[mid])) swap(students[high], students[mid]);
+        uint16_t pivot = birthdayKey(students[mid]);
+
+        // [low, lt) < pivot, [lt, i) == pivot, (gt, high] > pivot
+        int lt = low, i = low, gt = high;
+        while (i <= gt) {
+            uint16_t key = birthdayKey(students[i]);
+            if (key < pivot) {
+                swap(students[lt++], students[i++]);
+            } else if (key > pivot) {
+                swap(students[i], students[gt--]);
+            } else {
+                i++;
+            }
+        }
 
-    for (int j = low; j < high; j++) {
-        if (compare(students[j], pivot)) {
-            i++;
-            swap(students[i], students[j]);
+        if (lt - low < high - gt) {
+            quickSort(students, low, lt - 1, depthLimit);
+            low = gt + 1;
+        } else {
+            quickSort(students, gt + 1, high, depthLimit);
+            high = lt - 1;
         }
     }
-    swap(students[i + 1], students[high]);
-    return i + 1;
 }
 
 void quickSort(vector<Student>& students, int low, int high) {
-    if (low < high) {
-        int pi = partition(students, low, high);
-        quickSort(students, low, pi - 1);
-        quickSort(students, pi + 1, high);
+    int depthLimit = 0;
+    for (int n = high - low + 1; n > 1; n >>= 1) {
+        depthLimit += 2;
     }
+    quickSort(students, low, high, depthLimit);
 }
 
 #endif // STUDENT_MANAGER_H
@@ -0,0 +1,44 @@
+#include "../../common/external_sort.h"
+#include <iomanip>
+#include <sys/resource.h>
+
+// Usage: ./external_sort [input.csv] [output.csv] [--memory-mb 64] [--temp-dir .]
+// Same order as demo's students_sorted.csv, for inputs that do not fit in memory.
+int main(int argc, char* argv[]) {
+    string input = "students.csv";
+    string output = "students_sorted.csv";
+    ExternalSortOptions options;
+
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--memory-mb" && i + 1 < argc) {
+            options.memoryBudget = stoul(argv[++i]) << 20;
+        } else if (arg == "--temp-dir" && i + 1 < argc) {
+            options.tempDir = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() > 0) input = positional[0];
+    if (positional.size() > 1) output = positional[1];
+
+    ExternalSortStats stats;
+    if (!externalSortByBirthday(input, output, options, stats)) {
+        return 1;
+    }
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    cout << "Sorted " << stats.rows << " rows (" << stats.bytes / (1 << 20) << " MB) into " << output << endl;
+    if (stats.skippedRows > 0) {
+        cout << "Skipped " << stats.skippedRows << " unparsable rows" << endl;
+    }
+    cout << "Memory budget: " << options.memoryBudget / (1 << 20) << " MB | Runs: " << stats.runs
+         << " | Merge passes: " << stats.mergePasses << endl;
+    cout << fixed << setprecision(2) << "Time: " << stats.seconds << " s | Rows/sec: "
+         << setprecision(0) << stats.rowsPerSecond() << endl;
+    cout << "Peak RSS: " << usage.ru_maxrss / 1024 << " MB" << endl;
+    return 0;
+}
@@ -1,155 +1,115 @@
 #include "student_manager.h"
-#include <iostream>
-#include <chrono>
-#include <random>
-#include <iomanip>
-
-using namespace std;
-using namespace chrono;
-
-int main() {
-    vector<Student> students = readCSVToVector("students.csv");
-
-    cout << "Loading students from CSV..." << endl;
-    cout << "Loaded " << students.size() << " students" << endl << endl;
+#include "../../common/benchmark.h"
 
+// Linear scans over one vector, no cache
+class VectorBackend {
+private:
+    vector<Student> students;
     vector<string> emails;
     vector<string> groups;
 
-    for (const auto& student : students) {
-        emails.push_back(student.m_email);
-    }
+public:
+    static constexpr const char* kName = "Vector";
+    static constexpr const char* kDescription = "WITHOUT CACHE";
 
-    vector<pair<string, int>> groupSet;
-    for (const auto& student : students) {
-        bool found = false;
-        for (auto& pair : groupSet) {
-            if (pair.first == student.m_group) {
-                pair.second++;
-                found = true;
-                break;
+    bool load(const string& dataset) {
+        students = readCSVToVectorParallel(dataset);
+        for (const auto& student : students) {
+            emails.push_back(student.m_email);
+            if (find(groups.begin(), groups.end(), student.m_group) == groups.end()) {
+                groups.push_back(student.m_group);
             }
         }
-        if (!found) {
-            groupSet.push_back({student.m_group, 1});
-        }
+        sortKeys(emails);
+        sortKeys(groups);
+        return !students.empty();
     }
 
-    for (const auto& pair : groupSet) {
-        groups.push_back(pair.first);
-    }
+    size_t size() const { return students.size(); }
+    size_t emailCount() const { return emails.size(); }
+    size_t groupCount() const { return groups.size(); }
 
-    if (emails.empty() || groups.empty()) {
-        cerr << "No data loaded!" << endl;
-        return 1;
+    void mostStudents() {
+        int maxCount;
+        groupWithMostStudents(students, maxCount);
     }
 
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> emailDist(0, emails.size() - 1);
-    uniform_int_distribution<> groupDist(0, groups.size() - 1);
-    uniform_int_distribution<> opDist(1, 106);
-
-    cout << "Starting benchmark WITHOUT CACHE (10 seconds)..." << endl;
-    cout << "Operation ratio - Op1:Op2:Op3 = 5:1:100" << endl << endl;
-
-    int op1Count = 0, op2Count = 0, op3Count = 0;
-    int totalOps = 0;
-
-    auto startTime = high_resolution_clock::now();
-    auto endTime = startTime + seconds(10);
-
-    while (high_resolution_clock::now() < endTime) {
-        int opType = opDist(gen);
-
-        if (opType <= 5) {
-            // Operation 1: Find group with most students
-            vector<pair<string, int>> groupCount;
-            for (const auto& student : students) {
-                bool found = false;
-                for (auto& pair : groupCount) {
-                    if (pair.first == student.m_group) {
-                        pair.second++;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    groupCount.push_back({student.m_group, 1});
-                }
-            }
-            string maxGroup;
-            int maxCount = 0;
-            for (const auto& pair : groupCount) {
-                if (pair.second > maxCount) {
-                    maxCount = pair.second;
-                    maxGroup = pair.first;
-                }
-            }
-            op1Count++;
-        } else if (opType == 6) {
-            // Operation 2: Change student group
-            string email = emails[emailDist(gen)];
-            string newGroup = groups[groupDist(gen)];
-            changeGroupByEmail(students, email, newGroup);
-            op2Count++;
-        } else {
-            // Operation 3: Find group with highest rating
-            vector<pair<string, GroupStats>> groupStats;
-            for (const auto& student : students) {
-                bool found = false;
-                for (auto& pair : groupStats) {
-                    if (pair.first == student.m_group) {
-                        pair.second.studentCount++;
-                        pair.second.totalRating += student.m_rating;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    GroupStats stats;
-                    stats.studentCount = 1;
-                    stats.totalRating = student.m_rating;
-                    groupStats.push_back({student.m_group, stats});
-                }
-            }
-            string bestGroup;
-            double maxAvgRating = 0.0;
-            for (const auto& pair : groupStats) {
-                double avgRating = pair.second.getAverageRating();
-                if (avgRating > maxAvgRating) {
-                    maxAvgRating = avgRating;
-                    bestGroup = pair.first;
-                }
-            }
-            op3Count++;
-        }
-
-        totalOps++;
+    void changeGroup(size_t email, size_t group) {
+        changeGroupByEmail(students, emails[email], groups[group]);
     }
 
-    auto actualEndTime = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(actualEndTime - startTime).count();
+    void highestRating() {
+        double maxAvgRating;
+        groupWithHighestRating(students, maxAvgRating);
+    }
 
-    cout << "=== BENCHMARK RESULTS (WITHOUT CACHE) ===" << endl;
-    cout << "Duration: " << duration << " ms" << endl;
-    cout << "Total operations: " << totalOps << endl;
-    cout << "Operations per second: " << (totalOps * 1000.0 / duration) << endl << endl;
+    string mostStudentsGroup() {
+        int maxCount;
+        return groupWithMostStudents(students, maxCount);
+    }
 
-    cout << "Operation 1 (Find group with most students): " << op1Count << endl;
-    cout << "Operation 2 (Change student group): " << op2Count << endl;
-    cout << "Operation 3 (Find group with highest rating): " << op3Count << endl << endl;
+    string highestRatingGroup() {
+        double maxAvgRating;
+        return groupWithHighestRating(students, maxAvgRating);
+    }
 
-    cout << "Actual ratio: " << op1Count << ":" << op2Count << ":" << op3Count << endl;
+    const vector<Student>& roster() const {
+        return students;
+    }
+};
+
+// Microseconds per call of fn, over `repeats` calls
+template <class Fn>
+double microsPerCall(size_t repeats, Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; i++) {
+        fn();
+    }
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repeats;
+}
 
-    double ratio1 = op2Count > 0 ? (double)op1Count / op2Count : 0;
-    double ratio3 = op2Count > 0 ? (double)op3Count / op2Count : 0;
-    cout << "Normalized ratio: " << fixed << setprecision(1)
-         << ratio1 << ":1:" << ratio3 << endl;
+// The same Op1/Op3 full scans over StudentColumns (group ids instead of strings)
+void printColumnScans(VectorBackend& backend) {
+    const vector<Student>& students = backend.roster();
+    auto start = chrono::steady_clock::now();
+    StudentColumns columns = toColumns(students);
+    double buildMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    const size_t repeats = 20;
+    int maxCount;
+    uint32_t maxColumnCount;
+    double maxAvgRating;
+    double rowsOp1 = microsPerCall(repeats, [&]() { groupWithMostStudents(students, maxCount); });
+    double columnsOp1 = microsPerCall(repeats, [&]() { groupIdWithMostStudents(columns, maxColumnCount); });
+    double rowsOp3 = microsPerCall(repeats, [&]() { groupWithHighestRating(students, maxAvgRating); });
+    double columnsOp3 = microsPerCall(repeats, [&]() { groupIdWithHighestRating(columns, maxAvgRating); });
+
+    bool same = columns.groupNames[groupIdWithMostStudents(columns, maxColumnCount)] ==
+                    groupWithMostStudents(students, maxCount) &&
+                columns.groupNames[groupIdWithHighestRating(columns, maxAvgRating)] ==
+                    groupWithHighestRating(students, maxAvgRating);
+
+    cout << "\nColumn scans (toColumns took " << fixed << setprecision(1) << buildMillis << " ms):" << endl;
+    cout << "  Op1: " << rowsOp1 << " us over rows, " << columnsOp1 << " us over columns" << endl;
+    cout << "  Op3: " << rowsOp3 << " us over rows, " << columnsOp3 << " us over columns" << endl;
+    cout << "  Answers: " << (same ? "identical" : "different") << endl;
+}
 
-    cout << "\n=== VERIFICATION ===" << endl;
-    cout << "Group with most students: " << findGroupWithMostStudents(students) << endl;
-    cout << "Group with highest rating: " << findGroupWithHighestRating(students) << endl;
+// --column-scans adds printColumnScans (a full copy of the roster and 80 more scans) to
+// the run; the other options go to the driver
+int main(int argc, char* argv[]) {
+    bool columnScans = false;
+    vector<char*> args;
+    for (int i = 0; i < argc; i++) {
+        if (string(argv[i]) == "--column-scans") {
+            columnScans = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
 
-    return 0;
+    VectorBackend backend;
+    return benchmarkMain(backend, static_cast<int>(args.size()), args.data(), [&](VectorBackend& run) {
+        if (columnScans) printColumnScans(run);
+    });
 }
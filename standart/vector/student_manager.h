@@ -8,6 +8,10 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include "../../common/mapped_csv.h"
+#include "../../common/student_columns.h"
+#include "../../common/birthday_sort.h"
+#include "../../common/csv_writer.h"
 
 using namespace std;
 
@@ -84,6 +88,30 @@ vector<Student> readCSVToVector(const string& filename) {
     return students;
 }
 
+// Parses the file on `threads` workers (0 = all cores), keeps file order
+vector<Student> readCSVToVectorParallel(const string& filename, unsigned threads = 0) {
+    vector<Student> students;
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        cerr << "Error opening file!" << endl;
+        return students;
+    }
+
+    vector<vector<Student>> chunks = parseCSVParallel<Student>(file, threads, makeStudent<Student>);
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.size();
+    }
+    students.reserve(total);
+
+    for (auto& chunk : chunks) {
+        move(chunk.begin(), chunk.end(), back_inserter(students));
+    }
+    return students;
+}
+
 bool changeGroupByEmail(vector<Student>& students,
                         const string& email, const string& newGroup) {
     for (auto& student : students) {
@@ -95,7 +123,8 @@ bool changeGroupByEmail(vector<Student>& students,
     return false;
 }
 
-string findGroupWithMostStudents(const vector<Student>& students) {
+// Op1 without printing
+string groupWithMostStudents(const vector<Student>& students, int& maxCount) {
     vector<pair<string, int>> groupCount;
 
     for (const auto& student : students) {
@@ -113,7 +142,7 @@ string findGroupWithMostStudents(const vector<Student>& students) {
     }
 
     string maxGroup;
-    int maxCount = 0;
+    maxCount = 0;
 
     for (const auto& pair : groupCount) {
         if (pair.second > maxCount) {
@@ -122,11 +151,19 @@ string findGroupWithMostStudents(const vector<Student>& students) {
         }
     }
 
+    return maxGroup;
+}
+
+string findGroupWithMostStudents(const vector<Student>& students) {
+    int maxCount;
+    string maxGroup = groupWithMostStudents(students, maxCount);
+
     cout << "Group " << maxGroup << " has the most students: " << maxCount << endl;
     return maxGroup;
 }
 
-string findGroupWithHighestRating(const vector<Student>& students) {
+// Op3 without printing
+string groupWithHighestRating(const vector<Student>& students, double& maxAvgRating) {
     vector<pair<string, GroupStats>> groupStats;
 
     for (const auto& student : students) {
@@ -148,7 +185,7 @@ string findGroupWithHighestRating(const vector<Student>& students) {
     }
 
     string bestGroup;
-    double maxAvgRating = 0.0;
+    maxAvgRating = 0.0;
 
     for (const auto& pair : groupStats) {
         double avgRating = pair.second.getAverageRating();
@@ -158,64 +195,38 @@ string findGroupWithHighestRating(const vector<Student>& students) {
         }
     }
 
-    cout << "Group " << bestGroup << " has the highest average rating: "
-         << fixed << setprecision(2) << maxAvgRating << endl;
     return bestGroup;
 }
 
-void radixSortByBirthday(vector<Student>& students) {
-    int n = students.size();
-    if (n == 0) return;
-
-    {
-        vector<vector<Student>> buckets(32);
-
-        for (const auto& student : students) {
-            buckets[student.m_birth_day].push_back(student);
-        }
-
-        int index = 0;
-        for (int i = 1; i <= 31; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
-    }
-
-    {
-        vector<vector<Student>> buckets(13);
+string findGroupWithHighestRating(const vector<Student>& students) {
+    double maxAvgRating;
+    string bestGroup = groupWithHighestRating(students, maxAvgRating);
 
-        for (const auto& student : students) {
-            buckets[student.m_birth_month].push_back(student);
-        }
+    cout << "Group " << bestGroup << " has the highest average rating: "
+         << fixed << setprecision(2) << maxAvgRating << endl;
+    return bestGroup;
+}
 
-        int index = 0;
-        for (int i = 1; i <= 12; i++) {
-            for (const auto& student : buckets[i]) {
-                students[index++] = student;
-            }
-        }
+StudentColumns toColumns(const vector<Student>& students) {
+    StudentColumns columns;
+    columns.reserve(students.size());
+    for (const auto& student : students) {
+        columns.add(student);
     }
+    return columns;
 }
 
-void saveToCSV(const vector<Student>& students, const string& filename) {
-    ofstream file(filename);
+// Counting sort on the packed (month, day) key; see common/birthday_sort.h
+void radixSortByBirthday(vector<Student>& students) {
+    sortByBirthday(students);
+}
 
-    if (!file.is_open()) {
+// threads > 1 formats and writes parallel chunks (see writeStudentsCSV)
+void saveToCSV(const vector<Student>& students, const string& filename, unsigned threads = 1) {
+    if (!writeStudentsCSV(students, filename, threads)) {
         cerr << "Error creating file!" << endl;
         return;
     }
-
-    file << "m_name,m_surname,m_email,m_birth_year,m_birth_month,m_birth_day,m_group,m_rating,m_phone_number\n";
-
-    for (const auto& s : students) {
-        file << s.m_name << "," << s.m_surname << "," << s.m_email << ","
-             << s.m_birth_year << "," << s.m_birth_month << "," << s.m_birth_day << ","
-             << s.m_group << "," << fixed << setprecision(2) << s.m_rating << ","
-             << s.m_phone_number << "\n";
-    }
-
-    file.close();
     cout << "\nFile saved: " << filename << endl;
 }
 
@@ -0,0 +1,115 @@
+#include "../standart/avl/student_manager.h"
+#include "test_util.h"
+#include <map>
+#include <random>
+
+struct Expected {
+    string group;
+    double rating;
+};
+
+string emailOf(size_t i) {
+    return "student" + to_string(i) + "@student.org";
+}
+
+// Ratings are multiples of 0.25, so every sum is exact and can be compared with ==
+Student makeTestStudent(size_t i, mt19937& rng) {
+    Student student;
+    student.m_name.assign("Ivan");
+    student.m_surname.assign("Koval");
+    student.m_email.assign(emailOf(i));
+    student.m_birth_year = 2000;
+    student.m_birth_month = 1;
+    student.m_birth_day = 2;
+    student.m_group.assign("G-" + to_string(rng() % 8));
+    student.m_rating = (rng() % 400) * 0.25;
+    student.m_phone_number.assign("+380500000000");
+    return student;
+}
+
+GroupStats bruteForceRange(const map<string, Expected>& students, const string& lo, const string& hi) {
+    GroupStats stats;
+    for (auto it = students.lower_bound(lo); it != students.end() && it->first <= hi; ++it) {
+        stats.studentCount++;
+        stats.totalRating += it->second.rating;
+    }
+    return stats;
+}
+
+void checkAgainstBruteForce(AVLTree& tree, const map<string, Expected>& students, mt19937& rng,
+                            const string& label) {
+    check(tree.size() == int(students.size()), label + ": size");
+
+    // Random ranges, including bounds that are not emails and empty or reversed ranges
+    bool sameRanges = true;
+    for (int i = 0; i < 200; i++) {
+        string lo = emailOf(rng() % 3000);
+        string hi = rng() % 4 == 0 ? lo + "~" : emailOf(rng() % 3000);
+        if (rng() % 8 == 0) lo = "student";
+        GroupStats got = tree.rangeAggregate(lo, hi);
+        GroupStats want = hi < lo ? GroupStats() : bruteForceRange(students, lo, hi);
+        sameRanges = sameRanges && got.studentCount == want.studentCount && got.totalRating == want.totalRating;
+    }
+    check(sameRanges, label + ": range aggregates");
+    GroupStats all = tree.rangeAggregate("", "~");
+    GroupStats want = bruteForceRange(students, "", "~");
+    check(all.studentCount == want.studentCount && all.totalRating == want.totalRating, label + ": whole tree");
+
+    // Per-group totals
+    map<string, GroupStats> groups;
+    for (const auto& entry : students) {
+        groups[entry.second.group].studentCount++;
+        groups[entry.second.group].totalRating += entry.second.rating;
+    }
+    bool sameGroups = true;
+    for (const auto& group : tree.getGroupStats()) {
+        const GroupStats& expected = groups[group.first];
+        sameGroups = sameGroups && group.second.studentCount == expected.studentCount &&
+                     group.second.totalRating == expected.totalRating;
+    }
+    check(sameGroups, label + ": group totals");
+
+    // In-order iteration gives the emails sorted
+    vector<string> emails;
+    tree.forEach([&](const Student& student) { emails.push_back(string(student.m_email.view())); });
+    vector<string> sorted;
+    for (const auto& entry : students) {
+        sorted.push_back(entry.first);
+    }
+    check(emails == sorted, label + ": email order");
+}
+
+int main() {
+    mt19937 rng(11);
+    AVLTree tree;
+    map<string, Expected> students;
+
+    // Inserts in random order, with repeated emails replacing the stored student
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 500; i++) {
+            Student student = makeTestStudent(rng() % 3000, rng);
+            students[string(student.m_email.view())] = {string(student.m_group.view()), student.m_rating};
+            tree.insert(student);
+        }
+        for (int i = 0; i < 100; i++) {
+            string email = emailOf(rng() % 3000);
+            string group = "G-" + to_string(rng() % 10);
+            bool known = students.count(email) > 0;
+            check(tree.changeGroup(email, group) == known, "changeGroup finds exactly the known emails");
+            if (known) students[email].group = group;
+        }
+        checkAgainstBruteForce(tree, students, rng, "round " + to_string(round));
+    }
+
+    // Ascending inserts only rotate one way
+    AVLTree ascending;
+    map<string, Expected> ascendingStudents;
+    for (size_t i = 0; i < 2000; i++) {
+        Student student = makeTestStudent(100000 + i, rng);
+        ascendingStudents[string(student.m_email.view())] = {string(student.m_group.view()), student.m_rating};
+        ascending.insert(student);
+    }
+    checkAgainstBruteForce(ascending, ascendingStudents, rng, "ascending inserts");
+
+    return testResult("avl_aggregate");
+}
@@ -0,0 +1,44 @@
+#include "../standart/vector/student_manager.h"
+#include "test_util.h"
+
+bool inBirthdayOrder(const vector<Student>& students) {
+    for (size_t i = 1; i < students.size(); i++) {
+        if (birthdayKey(students[i]) < birthdayKey(students[i - 1])) return false;
+    }
+    return true;
+}
+
+int main() {
+    string csv = "/tmp/birthday_sort_test.csv";
+    writeTestCSV(csv,
+                 "Ivan,Koval,ivan@student.org,2000,5,2,KPI-01,90.00,+380500000001\n"
+                 "Olena,Melnyk,olena@student.org,2001,13,99,KPI-01,80.00,+380500000002\n"
+                 "Petro,Bondar,petro@student.org,2002,1,6,FIT-02,70.00,+380500000003\n"
+                 "Taras,Tkachenko,taras@student.org,2002,-4,-1,FIT-02,70.00,+380500000004\n"
+                 "Maria,Kravchenko,maria@student.org,2002,100000,7,FIT-02,70.00,+380500000005\n");
+
+    // Bad rows sort to the ends instead of indexing past the histogram
+    vector<Student> students = readCSVToVector(csv);
+    check(students.size() == 5, "five students loaded");
+    radixSortByBirthday(students);
+    check(students.size() == 5 && inBirthdayOrder(students), "serial sort keeps every row in order");
+    check(students.front().m_email == "taras@student.org", "negative month sorts first");
+    check(students[1].m_email == "petro@student.org" && students[2].m_email == "ivan@student.org",
+          "valid rows keep their order");
+    check(students[3].m_email == "maria@student.org" && students[4].m_email == "olena@student.org",
+          "months past 12 sort last");
+
+    vector<const Student*> pointers = sortedByBirthday<Student>(students, students.size());
+    check(pointers.size() == 5 && pointers.front()->m_email == "taras@student.org", "pointer sort");
+
+    // The parallel sort only splits inputs of at least 2 * 4096 records
+    vector<Student> many(20000, students[2]);
+    many[777].m_birth_month = 5000;
+    many[15000].m_birth_day = -30;
+    sortByBirthdayParallel(many, 4);
+    check(inBirthdayOrder(many), "parallel sort with bad rows");
+    check(many.front().m_birth_day == -30 && many.back().m_birth_month == 5000, "bad rows at the ends");
+
+    remove(csv.c_str());
+    return testResult("birthday_sort");
+}
@@ -0,0 +1,47 @@
+#include "../standart/btree/student_manager.h"
+#include "test_util.h"
+
+Student makeTestStudent(size_t i) {
+    Student student;
+    student.m_name.assign("Ivan");
+    student.m_surname.assign("Koval");
+    student.m_email.assign("student" + to_string(i) + "@student.org");
+    student.m_birth_year = 2000;
+    student.m_birth_month = 1 + i % 12;
+    student.m_birth_day = 1 + i % 28;
+    student.m_group.assign(i % 3 == 0 ? "KPI-01" : "FIT-02");
+    student.m_rating = 60.0 + i % 40;
+    student.m_phone_number.assign("+380500000000");
+    return student;
+}
+
+// A moved-from tree must be empty and usable, not point into the moved nodes
+void checkEmptyAndUsable(BTree& tree, const string& label) {
+    check(tree.size() == 0 && tree.getHeight() == 0, label + ": empty");
+    check(tree.search("student5@student.org") == nullptr, label + ": search misses");
+    check(tree.begin() == tree.end(), label + ": no iteration");
+    tree.insert(makeTestStudent(5));
+    check(tree.size() == 1 && tree.search("student5@student.org") != nullptr, label + ": insert works");
+}
+
+int main() {
+    BTree tree;
+    for (size_t i = 0; i < 1000; i++) {
+        tree.insert(makeTestStudent(i));
+    }
+    check(tree.getHeight() > 1, "several levels");
+
+    BTree moved(move(tree));
+    check(moved.size() == 1000 && moved.search("student999@student.org") != nullptr, "move constructor keeps data");
+    checkEmptyAndUsable(tree, "after move construction");
+
+    BTree assigned;
+    assigned.insert(makeTestStudent(2000));
+    assigned = move(moved);
+    check(assigned.size() == 1000 && assigned.search("student0@student.org") != nullptr &&
+              assigned.search("student2000@student.org") == nullptr,
+          "move assignment replaces data");
+    checkEmptyAndUsable(moved, "after move assignment");
+
+    return testResult("btree_move");
+}
@@ -0,0 +1,66 @@
+#include "../optimized/change_log.h"
+#include "test_util.h"
+#include <csignal>
+#include <sys/resource.h>
+
+size_t countRecords(const string& filename) {
+    size_t records = 0;
+    replayChangeLog(filename, [](string_view, string_view) {}, records);
+    return records;
+}
+
+int main() {
+    string wal = "/tmp/change_log_test.wal";
+    ChangeLog log;
+    check(log.open(wal, 0), "open a new log");
+
+    uint64_t first = log.append("ivan@student.org", "KPI-01");
+    uint64_t second = log.append("olena@student.org", "FIT-02");
+    check(first == 1 && second == 2, "sequence numbers start at 1");
+    check(log.append(string(kMaxChangeLogField + 1, 'a'), "KPI-01") == 0, "oversized email refused");
+    check(log.append("ivan@student.org", string(kMaxChangeLogField + 1, 'b')) == 0, "oversized group refused");
+    check(!log.waitDurable(0), "lsn 0 is never durable");
+    check(log.waitDurable(second), "wait for one change");
+    check(countRecords(wal) == 2, "both changes replay");
+
+    // A reopen (as after a checkpoint) keeps counting, and old lsns stay durable
+    check(log.open(wal, 0), "reopen empty");
+    check(log.waitDurable(second), "an lsn from before the reopen is durable");
+    check(log.append("petro@student.org", "KPI-01") == 3, "sequence numbers continue");
+    check(log.sync(), "sync after reopen");
+
+    // A write past RLIMIT_FSIZE fails; the log must not report anything after it durable
+    signal(SIGXFSZ, SIG_IGN);
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    rlimit limit = saved;
+    limit.rlim_cur = 4096;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    string longEmail(3000, 'a');
+    uint64_t lost = 0;
+    for (int i = 0; i < 4; i++) {
+        lost = log.append(longEmail, "KPI-01");
+    }
+    check(!log.waitDurable(lost), "a failed write is not durable");
+    setrlimit(RLIMIT_FSIZE, &saved);
+
+    uint64_t later = log.append("ivan@student.org", "FIT-02");
+    check(later == 0 && !log.accepting(), "appends are refused after the error");
+    check(!log.sync(), "sync stays failed after the error");
+
+    // A new log (after a checkpoint) works again
+    check(log.open(wal, 0), "reopen after the error");
+    uint64_t fresh = log.append("ivan@student.org", "KPI-01");
+    check(fresh > lost && log.waitDurable(fresh), "durable again after reopen");
+    log.close();
+    check(countRecords(wal) == 1, "the new log holds one change");
+    check(log.append("ivan@student.org", "KPI-01") == 0, "a closed log refuses appends");
+
+    // A failed open leaves the log failed instead of waiting forever
+    check(!log.open("/nonexistent-dir/change_log_test.wal", 0), "open in a missing directory fails");
+    check(log.append("ivan@student.org", "KPI-01") == 0 && !log.waitDurable(fresh + 1),
+          "after a failed open appends are refused and waits return");
+
+    remove(wal.c_str());
+    return testResult("change_log");
+}
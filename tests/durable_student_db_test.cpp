@@ -0,0 +1,56 @@
+#include "../optimized/durable_student_db.h"
+#include "test_util.h"
+#include <sys/stat.h>
+
+int main() {
+    string csv = "/tmp/durable_student_db_test.csv";
+    writeThreeStudentCSV(csv);
+    DurableOptions options;
+    options.snapshotFile = "/tmp/durable_student_db_test.snap";
+    options.logFile = "/tmp/durable_student_db_test.wal";
+    options.checkpointEvery = 0;
+    remove(options.snapshotFile.c_str());
+    remove(options.logFile.c_str());
+
+    {
+        DurableStudentDB db(options);
+        check(db.open(csv), "open from the CSV");
+        uint64_t lsn = db.changeGroupByEmail("petro@student.org", "KPI-01");
+        check(lsn > 0 && db.waitDurable(lsn), "a logged change becomes durable");
+        check(db.changeGroupByEmail("nobody@student.org", "KPI-01") == 0, "unknown email");
+
+        // A group the log cannot hold is refused before it changes anything
+        check(db.changeGroupByEmail("ivan@student.org", string(kMaxChangeLogField + 1, 'g')) == 0,
+              "oversized group refused");
+        check(db.changeGroupsByEmail({{"ivan@student.org", "FIT-02"},
+                                      {"olena@student.org", string(kMaxChangeLogField + 1, 'g')}}) == 0,
+              "batch with an oversized group refused");
+        vector<GroupSummary> top = db.database().topGroupsByStudents(1);
+        check(db.database().getAllGroups().size() == 1 && top.size() == 1 && top[0].studentCount == 3,
+              "refused changes left no trace");
+    }
+
+    // The restart replays the one logged change
+    DurableStudentDB reopened(options);
+    check(reopened.open(csv) && reopened.replayedChanges() == 1, "restart replays the log");
+    check(reopened.database().findGroupWithMostStudents() == "KPI-01", "replayed state");
+
+    // A checkpoint that cannot write its snapshot is reported and retried later, not on every change
+    // (a directory in the way of the snapshot's temp file makes every save fail)
+    DurableOptions broken = options;
+    broken.checkpointEvery = 2;
+    string blocker = broken.snapshotFile + ".tmp";
+    mkdir(blocker.c_str(), 0755);
+    DurableStudentDB failing(broken);
+    check(failing.open(csv), "open with automatic checkpoints");
+    for (int i = 0; i < 10; i++) {
+        failing.changeGroupByEmail("olena@student.org", i % 2 ? "FIT-02" : "KPI-01");
+    }
+    check(failing.failedCheckpoints() == 3, "failed checkpoints back off (at 2, 4 and 8 changes)");
+
+    rmdir(blocker.c_str());
+    remove(csv.c_str());
+    remove(options.snapshotFile.c_str());
+    remove(options.logFile.c_str());
+    return testResult("durable_student_db");
+}
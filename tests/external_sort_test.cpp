@@ -0,0 +1,97 @@
+#include "../standart/vector/student_manager.h"
+#include "test_util.h"
+#include "../common/external_sort.h"
+#include <csignal>
+#include <dirent.h>
+#include <random>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+vector<string> emailsOf(const vector<Student>& students) {
+    vector<string> emails;
+    for (const auto& student : students) {
+        emails.push_back(student.m_email);
+    }
+    return emails;
+}
+
+size_t filesIn(const string& dir) {
+    size_t files = 0;
+    if (DIR* handle = opendir(dir.c_str())) {
+        while (dirent* entry = readdir(handle)) {
+            files += entry->d_name[0] != '.';
+        }
+        closedir(handle);
+    }
+    return files;
+}
+
+int main() {
+    // About 5 MB of rows: several runs under the 1 MB minimum budget, and more runs than
+    // one merge pass can read, so the intermediate passes run too. Birthdays repeat a lot,
+    // some are out of range, and one line does not parse.
+    string csv = "/tmp/external_sort_test.csv";
+    string sorted = "/tmp/external_sort_test_sorted.csv";
+    string tempDir = "/tmp/external_sort_test_runs";
+    mkdir(tempDir.c_str(), 0755);
+
+    mt19937 rng(5);
+    string rows;
+    for (int i = 0; i < 60000; i++) {
+        int month = 1 + rng() % 12;
+        int day = 1 + rng() % 28;
+        if (i % 1000 == 0) month = 13;
+        if (i % 1500 == 0) day = -3;
+        rows += "Ivan,Koval,student" + to_string(i) + "@student.org,2000," + to_string(month) + "," +
+                to_string(day) + ",KPI-01,75.50,+380500000000\n";
+        if (i == 30000) rows += "not,a,student\n";
+    }
+    writeTestCSV(csv, rows);
+
+    ExternalSortOptions options;
+    options.memoryBudget = 1 << 20;
+    options.tempDir = tempDir;
+    ExternalSortStats stats;
+    check(externalSortByBirthday(csv, sorted, options, stats), "external sort succeeds");
+    check(stats.rows == 60000 && stats.skippedRows == 1, "every student row sorted, the bad line skipped");
+    check(stats.runs > 3 && stats.mergePasses > 1, "several runs and merge passes");
+    check(filesIn(tempDir) == 0, "no run files left behind");
+
+    // Same stable order as the in-memory sort, out-of-range birthdays included
+    vector<Student> inMemory = readCSVToVectorParallel(csv);
+    radixSortByBirthday(inMemory);
+    vector<Student> external = readCSVToVectorParallel(sorted);
+    check(inMemory.size() == 60000, "in-memory load skips the bad line too");
+    check(emailsOf(external) == emailsOf(inMemory), "same order as sortByBirthday");
+
+    // One run that fits the budget is merged straight into the output
+    ExternalSortOptions large;
+    large.memoryBudget = 64 << 20;
+    large.tempDir = tempDir;
+    check(externalSortByBirthday(csv, sorted, large, stats), "sort within one run");
+    check(stats.runs == 1 && stats.mergePasses == 1, "one run, one pass");
+    check(emailsOf(readCSVToVectorParallel(sorted)) == emailsOf(inMemory), "one run: same order");
+
+    // Runs of about 0.9 MB can be written, but not the 2.7 MB file of the first merge pass:
+    // the pass fails and the runs it did not reach are removed with the others
+    signal(SIGXFSZ, SIG_IGN);
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    rlimit limit = saved;
+    limit.rlim_cur = 2 << 20;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    check(!externalSortByBirthday(csv, sorted, options, stats), "a failed merge pass fails the sort");
+    setrlimit(RLIMIT_FSIZE, &saved);
+    check(stats.runs > 3, "the runs were written before the failure");
+    check(filesIn(tempDir) == 0, "no run files left after a failed merge pass");
+
+    // A missing temp dir fails without leaving anything behind
+    options.tempDir = tempDir + "/missing";
+    check(!externalSortByBirthday(csv, sorted, options, stats), "missing temp dir fails");
+    check(filesIn(tempDir) == 0, "no run files left after a failure");
+
+    remove(csv.c_str());
+    remove(sorted.c_str());
+    rmdir(tempDir.c_str());
+    return testResult("external_sort");
+}
@@ -0,0 +1,69 @@
+#include "../common/flat_email_index.h"
+#include "test_util.h"
+#include <random>
+#include <unordered_map>
+
+struct Record {
+    string m_email;
+};
+
+string randomEmail(mt19937& rng) {
+    string email;
+    size_t length = 1 + rng() % 12;
+    for (size_t i = 0; i < length; i++) {
+        email += char('a' + rng() % 4);  // a small alphabet, so emails repeat
+    }
+    return email + "@student.org";
+}
+
+// Inserts and looks up random emails in both tables; hashOf picks the hash, so a bad
+// hash can force long probe sequences
+template <class HashFn>
+void compareWithUnorderedMap(size_t operations, size_t reserved, HashFn&& hashOf, const string& label) {
+    mt19937 rng(7);
+    FlatEmailIndex index;
+    index.reserve(reserved);
+    vector<Record> records;
+    unordered_map<string, uint32_t> expected;
+
+    bool same = true;
+    for (size_t i = 0; i < operations; i++) {
+        string email = randomEmail(rng);
+        uint32_t hash = hashOf(email);
+        auto it = expected.find(email);
+        uint32_t want = it == expected.end() ? FlatEmailIndex::kNotFound : it->second;
+        same = same && index.find(email, hash, records) == want;
+
+        if (it == expected.end() && rng() % 2 == 0) {
+            uint32_t recordIndex = static_cast<uint32_t>(records.size());
+            records.push_back({email});
+            index.insert(hash, recordIndex);
+            expected.emplace(email, recordIndex);
+        }
+    }
+    check(same, label + ": every lookup matches unordered_map");
+    check(index.size() == expected.size(), label + ": same size");
+
+    // Every key once more after all the rehashes
+    size_t found = 0;
+    for (const auto& entry : expected) {
+        found += index.find(entry.first, hashOf(entry.first), records) == entry.second;
+    }
+    check(found == expected.size(), label + ": every key is found at the end");
+}
+
+int main() {
+    auto realHash = [](const string& email) { return FlatEmailIndex::hashEmail(email); };
+    compareWithUnorderedMap(200000, 0, realHash, "growing from one group");
+    compareWithUnorderedMap(200000, 100000, realHash, "reserved");
+
+    // Few distinct hashes: long probe chains and equal control bytes for different keys
+    auto fewHashes = [](const string& email) { return FlatEmailIndex::hashEmail(email) % 64; };
+    compareWithUnorderedMap(20000, 0, fewHashes, "64 hashes");
+
+    // One hash for everything: every lookup has to compare the emails
+    auto oneHash = [](const string&) { return uint32_t(12345); };
+    compareWithUnorderedMap(3000, 0, oneHash, "one hash");
+
+    return testResult("flat_email_index");
+}
@@ -0,0 +1,107 @@
+#include "../optimized/student_manager_o.h"
+#include "test_util.h"
+#include <random>
+
+// Group ids ordered best first from the current group stats, the way a full rebuild ranks them
+vector<uint32_t> expectedOrder(const OptimizedStudentDB& db, bool byRating) {
+    vector<uint32_t> ids = db.getAllGroupIds();
+    sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) {
+        GroupSummary x = db.summarize(a);
+        GroupSummary y = db.summarize(b);
+        if (byRating && x.averageRating != y.averageRating) return x.averageRating > y.averageRating;
+        if (!byRating && x.studentCount != y.studentCount) return x.studentCount > y.studentCount;
+        return a < b;
+    });
+    return ids;
+}
+
+vector<uint32_t> rankedIds(const vector<GroupSummary>& groups) {
+    vector<uint32_t> ids;
+    for (const auto& group : groups) {
+        ids.push_back(group.groupId);
+    }
+    return ids;
+}
+
+void checkRankings(OptimizedStudentDB& db, const string& label) {
+    size_t groups = db.groupCount();
+    vector<uint32_t> byCount = expectedOrder(db, false);
+    vector<uint32_t> byRating = expectedOrder(db, true);
+    check(rankedIds(db.topGroupsByStudents(groups)) == byCount, label + ": order by students");
+    check(rankedIds(db.topGroupsByRating(groups)) == byRating, label + ": order by rating");
+    check(!byCount.empty() && db.mostStudentsGroupId() == byCount[0], label + ": most students");
+    check(!byRating.empty() && db.highestRatingGroupId() == byRating[0], label + ": highest rating");
+    if (!byCount.empty()) {
+        const string& last = db.groupName(byCount.back());
+        check(db.groupRankByStudents(last) == byCount.size(), label + ": rank of the last group");
+    }
+}
+
+int main() {
+    // 2000 students in 40 groups; ratings are multiples of 0.25, so the sums are exact and
+    // equal averages really tie
+    string csv = "/tmp/group_ranking_test.csv";
+    string rows;
+    for (int i = 0; i < 2000; i++) {
+        string group = "G-" + to_string(i % 40);
+        rows += "Ivan,Koval,student" + to_string(i) + "@student.org,2000,1,2," + group + "," +
+                to_string(50 + (i * 37) % 50) + ".25,+380500000000\n";
+    }
+    writeTestCSV(csv, rows);
+
+    OptimizedStudentDB db;
+    db.loadFromCSV(csv);
+    check(db.getStudentCount() == 2000 && db.groupCount() == 40, "roster loaded");
+    checkRankings(db, "after load");
+
+    // Single changes, batches and new group names, checked against the order a full
+    // scan of the stats gives
+    mt19937 rng(42);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 40; i++) {
+            string email = "student" + to_string(rng() % 2000) + "@student.org";
+            db.changeGroupByEmail(email, uint32_t(rng() % db.groupCount()));
+        }
+        vector<pair<string, uint32_t>> batch;
+        for (int i = 0; i < 40; i++) {
+            string email = "student" + to_string(rng() % 2000) + "@student.org";
+            batch.push_back({email, uint32_t(rng() % db.groupCount())});
+        }
+        db.changeGroupsByEmail(batch);
+        if (round % 10 == 9) {
+            db.changeGroupByEmail("student" + to_string(rng() % 2000) + "@student.org", "NEW-" + to_string(round));
+        }
+        checkRankings(db, "round " + to_string(round));
+    }
+
+    // An unknown email changes nothing and creates no group, alone or in a batch
+    size_t groupsBefore = db.groupCount();
+    check(!db.changeGroupByEmail("nobody@student.org", string("GHOST-1")), "unknown email refused");
+    vector<pair<string, string>> named = {{"nobody@student.org", "GHOST-2"}, {"student1@student.org", "REAL-1"}};
+    check(db.changeGroupsByEmail(named) == 1, "batch finds only the known email");
+    check(db.groupCount() == groupsBefore + 1, "only the group of the known email is created");
+    checkRankings(db, "after unknown emails");
+
+    // A full rebuild agrees with the incrementally maintained rankings
+    vector<uint32_t> byCount = rankedIds(db.topGroupsByStudents(db.groupCount()));
+    vector<uint32_t> byRating = rankedIds(db.topGroupsByRating(db.groupCount()));
+    db.rebuildCache();
+    check(rankedIds(db.topGroupsByStudents(db.groupCount())) == byCount, "rebuild: same order by students");
+    check(rankedIds(db.topGroupsByRating(db.groupCount())) == byRating, "rebuild: same order by rating");
+
+    // Emptying a group drops it from both rankings
+    uint32_t emptied = db.mostStudentsGroupId();
+    uint32_t target = emptied == 0 ? 1 : 0;
+    vector<pair<string, uint32_t>> moveOut;
+    for (int i = 0; i < 2000; i++) {
+        moveOut.push_back({"student" + to_string(i) + "@student.org", target});
+    }
+    db.changeGroupsByEmail(moveOut);
+    check(db.groupRankByStudents(db.groupName(emptied)) == 0, "an empty group is not ranked by students");
+    check(db.groupRankByRating(db.groupName(emptied)) == 0, "an empty group is not ranked by rating");
+    check(db.topGroupsByStudents(db.groupCount()).size() == 1, "only one group left");
+    checkRankings(db, "everyone in one group");
+
+    remove(csv.c_str());
+    return testResult("group_ranking");
+}
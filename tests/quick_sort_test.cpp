@@ -0,0 +1,51 @@
+#include "../standart/hash/student_manager.h"
+#include "test_util.h"
+#include <random>
+
+Student makeTestStudent(int month, int day) {
+    Student student;
+    student.m_email = "student" + to_string(month) + "_" + to_string(day) + "@student.org";
+    student.m_birth_month = month;
+    student.m_birth_day = day;
+    student.m_rating = 0.0;
+    return student;
+}
+
+bool inBirthdayOrder(const vector<Student>& students) {
+    for (size_t i = 1; i < students.size(); i++) {
+        if (birthdayKey(students[i]) < birthdayKey(students[i - 1])) return false;
+    }
+    return true;
+}
+
+int main() {
+    // Valid dates mixed with out-of-range ones: quickSort must agree with the clamped key
+    // of sortByBirthday, e.g. month 13 day 1 sorts with December 1, not after December 31
+    mt19937 rng(3);
+    vector<Student> students;
+    for (int i = 0; i < 20000; i++) {
+        int month = int(rng() % 16) - 2;
+        int day = int(rng() % 40) - 4;
+        students.push_back(makeTestStudent(month, day));
+    }
+
+    vector<Student> quick = students;
+    quickSort(quick, 0, int(quick.size()) - 1);
+    check(inBirthdayOrder(quick), "introsort orders by the clamped key");
+
+    // Depth limit 0 goes straight to the heapsort fallback
+    vector<Student> heap = students;
+    quickSort(heap, 0, int(heap.size()) - 1, 0);
+    check(inBirthdayOrder(heap), "heapsort fallback orders by the clamped key");
+
+    vector<Student> counting = students;
+    sortByBirthday(counting);
+    bool sameKeys = true;
+    for (size_t i = 0; i < students.size(); i++) {
+        sameKeys = sameKeys && birthdayKey(quick[i]) == birthdayKey(counting[i]) &&
+                   birthdayKey(heap[i]) == birthdayKey(counting[i]);
+    }
+    check(sameKeys, "same key sequence as sortByBirthday");
+
+    return testResult("quick_sort");
+}
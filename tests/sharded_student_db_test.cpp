@@ -0,0 +1,29 @@
+#include "../optimized/sharded_student_db.h"
+#include "test_util.h"
+
+int main() {
+    string csv = "/tmp/sharded_student_db_test.csv";
+    writeThreeStudentCSV(csv);
+
+    ShardedStudentDB db(4);
+    db.loadFromCSV(csv, 2);
+    check(db.getStudentCount() == 3, "three students loaded");
+    vector<uint32_t> ids = db.getAllGroupIds();
+    check(ids.size() == 2, "two groups");
+
+    // Ids that were never interned are rejected and leave no phantom group behind
+    check(!db.changeGroupByEmail("petro@student.org", uint32_t(ids.size())), "next unused id rejected");
+    check(!db.changeGroupByEmail("petro@student.org", UINT32_MAX), "UINT32_MAX rejected");
+    db.flush();
+    check(db.getAllGroupIds().size() == 2, "no phantom group");
+    check(db.findGroupWithMostStudents() == "KPI-01", "KPI-01 still has most students");
+
+    // Valid ids and new names still work
+    check(db.changeGroupByEmail("ivan@student.org", ids[1]), "move to an existing id");
+    check(db.changeGroupByEmail("olena@student.org", string("NXE-03")), "move to a new group name");
+    db.flush();
+    check(db.findGroupWithMostStudents() == "FIT-02", "FIT-02 has most students after the moves");
+
+    remove(csv.c_str());
+    return testResult("sharded_student_db");
+}
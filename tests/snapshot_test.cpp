@@ -0,0 +1,48 @@
+#include "../optimized/student_manager_o.h"
+#include "test_util.h"
+#include <fstream>
+
+// Overwrites the header's hash check and every stored email hash, as if the snapshot
+// came from a standard library with a different std::hash
+bool forgeForeignHashes(const string& filename) {
+    fstream file(filename, ios::in | ios::out | ios::binary);
+    SnapshotHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    header.emailHashCheck = ~emailHashCheck();
+    vector<uint32_t> garbage(header.studentCount, 12345u);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.seekp(header.offsets[kSnapshotEmailHashes]);
+    file.write(reinterpret_cast<const char*>(garbage.data()), garbage.size() * sizeof(uint32_t));
+    return file.good();
+}
+
+int main() {
+    string csv = "/tmp/snapshot_test.csv";
+    string snap = "/tmp/snapshot_test.snap";
+    writeThreeStudentCSV(csv);
+
+    OptimizedStudentDB original;
+    original.loadFromCSV(csv);
+    check(original.saveSnapshot(snap), "save snapshot");
+
+    OptimizedStudentDB loaded;
+    check(loaded.loadFromSnapshot(snap).rows == 3, "load snapshot");
+    const Student* petro = loaded.findStudent("petro@student.org");
+    check(petro && petro->m_name == "Petro" && loaded.groupName(petro->m_groupId) == "FIT-02",
+          "lookup after load");
+
+    // Hashes from another hash function are recomputed, so lookups still work
+    check(forgeForeignHashes(snap), "forge foreign hashes");
+    OptimizedStudentDB foreign;
+    check(foreign.loadFromSnapshot(snap).rows == 3, "load foreign snapshot");
+    for (const string& email : original.getAllEmails()) {
+        check(foreign.findStudent(email) != nullptr, "lookup of " + email + " after foreign load");
+    }
+    check(foreign.changeGroupByEmail("petro@student.org", string("KPI-01")), "change group after foreign load");
+    check(foreign.findGroupWithMostStudents() == "KPI-01", "KPI-01 has most students");
+
+    remove(csv.c_str());
+    remove(snap.c_str());
+    return testResult("snapshot");
+}
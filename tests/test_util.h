@@ -0,0 +1,47 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Every file in tests/ is a standalone program that includes this header:
+//   g++ -std=c++17 -O2 -pthread tests/<name>_test.cpp -o /tmp/test && /tmp/test
+// It prints FAILED: ... for every failed check and exits with 1 if any check failed.
+
+inline int failures = 0;
+
+inline void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAILED: " << what << endl;
+        failures++;
+    }
+}
+
+// Exit code of a test program
+inline int testResult(const string& name) {
+    if (failures == 0) {
+        cout << "All " << name << " tests passed" << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// Writes a students.csv with the usual header and the given rows
+inline void writeTestCSV(const string& filename, const string& rows) {
+    ofstream file(filename);
+    file << "m_name,m_surname,m_email,m_birth_year,m_birth_month,m_birth_day,m_group,m_rating,m_phone_number\n"
+         << rows;
+}
+
+// The three-student roster most tests start from: KPI-01 has Ivan and Olena (90 and 80),
+// FIT-02 has Petro (70)
+inline void writeThreeStudentCSV(const string& filename) {
+    writeTestCSV(filename,
+                 "Ivan,Koval,ivan@student.org,2000,1,2,KPI-01,90.00,+380500000001\n"
+                 "Olena,Melnyk,olena@student.org,2001,3,4,KPI-01,80.00,+380500000002\n"
+                 "Petro,Bondar,petro@student.org,2002,5,6,FIT-02,70.00,+380500000003\n");
+}
+
+#endif // TEST_UTIL_H
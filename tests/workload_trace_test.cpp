@@ -0,0 +1,126 @@
+#include "../common/benchmark.h"
+#include "test_util.h"
+#include <unistd.h>
+#include <unordered_map>
+
+// Records every op instead of running it; `dataset` is only the email count
+class RecordingBackend {
+private:
+    size_t emails = 0;
+
+public:
+    static constexpr const char* kName = "Recording";
+    static constexpr const char* kDescription = "records the ops";
+
+    vector<pair<size_t, size_t>> changes;
+    size_t reads = 0;
+
+    bool load(const string& dataset) {
+        emails = stoul(dataset);
+        return true;
+    }
+
+    size_t size() const { return emails; }
+    size_t emailCount() const { return emails; }
+    size_t groupCount() const { return 20; }
+    void mostStudents() { reads++; }
+    void changeGroup(size_t email, size_t group) { changes.push_back({email, group}); }
+    void highestRating() { reads++; }
+    string mostStudentsGroup() { return ""; }
+    string highestRatingGroup() { return ""; }
+};
+
+bool sameOps(const vector<WorkloadOp>& a, const vector<WorkloadOp>& b) {
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](const WorkloadOp& x, const WorkloadOp& y) {
+        return x.type == y.type && x.email == y.email && x.group == y.group;
+    });
+}
+
+int main() {
+    WorkloadSpec spec;
+    spec.mix[0] = 1;
+    spec.mix[1] = 2;
+    spec.mix[2] = 1;
+    spec.emailSkew = 0.9;
+
+    // The same seed gives the same ops, another seed other ops
+    vector<WorkloadOp> ops = WorkloadGenerator(spec, 1000, 20, 42).generate(10000);
+    check(sameOps(ops, WorkloadGenerator(spec, 1000, 20, 42).generate(10000)), "same seed, same ops");
+    check(!sameOps(ops, WorkloadGenerator(spec, 1000, 20, 43).generate(10000)), "another seed, other ops");
+    size_t changes = count_if(ops.begin(), ops.end(), [](const WorkloadOp& op) { return op.type == kOpChangeGroup; });
+    check(changes > 4500 && changes < 5500, "the mix is followed");
+    bool inRange = all_of(ops.begin(), ops.end(), [](const WorkloadOp& op) {
+        return op.type <= kOpHighestRating && op.email < 1000 && op.group < 20;
+    });
+    check(inRange, "ops stay inside the key counts");
+
+    // At theta 0.99 about 60% of the draws land on 1% of 200k keys
+    {
+        mt19937_64 gen(1);
+        KeyChooser keys(200000, 0.99);
+        unordered_map<size_t, size_t> hits;
+        for (int i = 0; i < 200000; i++) {
+            hits[keys(gen)]++;
+        }
+        vector<size_t> counts;
+        for (const auto& hit : hits) {
+            counts.push_back(hit.second);
+        }
+        sort(counts.rbegin(), counts.rend());
+        size_t top = 0;
+        for (size_t i = 0; i < min<size_t>(2000, counts.size()); i++) {
+            top += counts[i];
+        }
+        check(top > 200000 / 2 && top < 200000 * 7 / 10, "Zipf 0.99 puts about 60% on the top 1%");
+    }
+
+    // Record a run, then replay it: the same changes arrive in the same order, and the
+    // spec and seed come from the trace
+    string trace = "/tmp/workload_trace_test.trace";
+    BenchmarkConfig config;
+    config.dataset = "1000";
+    config.workload = spec;
+    config.seed = 7;
+    config.ops = 20000;
+    config.recordFile = trace;
+    config.warmupSeconds = 0;
+    RecordingBackend recorded;
+    BenchmarkResult recordResult;
+    check(runBenchmark(recorded, config, recordResult), "record a run");
+    check(recordResult.totalOps == 20000 && recordResult.opCounts[kOpChangeGroup] == recorded.changes.size(),
+          "every op ran once");
+
+    BenchmarkConfig replayConfig;
+    replayConfig.dataset = "1000";
+    replayConfig.replayFile = trace;
+    replayConfig.warmupSeconds = 0;
+    RecordingBackend replayed;
+    BenchmarkResult replayResult;
+    check(runBenchmark(replayed, replayConfig, replayResult), "replay the trace");
+    check(replayed.changes == recorded.changes && replayed.reads == recorded.reads, "replay runs the same ops");
+    check(replayResult.seed == 7 && replayResult.workload.mix[1] == 2 && replayResult.workload.emailSkew == 0.9,
+          "seed and spec come from the trace");
+
+    TraceHeader header;
+    vector<WorkloadOp> read;
+    check(readTrace(trace, header, read) && header.opCount == 20000 && header.emailCount == 1000, "trace header");
+
+    // A trace only replays on a dataset with the same counts
+    replayConfig.dataset = "999";
+    RecordingBackend smaller;
+    check(!runBenchmark(smaller, replayConfig, replayResult) && smaller.changes.empty(),
+          "other email count rejected");
+
+    // Invalid ops, a truncated file and a file that is no trace are rejected
+    vector<WorkloadOp> invalid = {{kOpChangeGroup, 1000, 0}};
+    check(writeTrace(trace, spec, 7, 1000, 20, invalid) && !readTrace(trace, header, read), "email out of range");
+    invalid = {{7, 0, 0}};
+    check(writeTrace(trace, spec, 7, 1000, 20, invalid) && !readTrace(trace, header, read), "unknown op type");
+    check(writeTrace(trace, spec, 7, 1000, 20, ops) && truncate(trace.c_str(), sizeof(TraceHeader) + 100) == 0 &&
+          !readTrace(trace, header, read), "truncated trace");
+    writeTestCSV(trace, "");
+    check(!readTrace(trace, header, read), "not a trace");
+
+    remove(trace.c_str());
+    return testResult("workload_trace");
+}
@@ -0,0 +1,188 @@
+#include "../common/csv_writer.h"
+#include "../common/workload.h"
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+using namespace chrono;
+
+// Same first names and surnames as the original students.csv
+const string_view kNames[] = {"Andrii", "Iryna", "Ivan", "Maria", "Oksana", "Olena", "Petro", "Taras"};
+const string_view kSurnames[] = {"Bondar", "Koval", "Kravchenko", "Melnyk", "Shevchenko", "Tkachenko"};
+const string_view kGroupPrefixes[] = {"ABC", "FIT", "KPI", "NXE"};
+
+// One row in the shape formatStudentRow expects
+struct GeneratedStudent {
+    string_view m_name;
+    string_view m_surname;
+    string_view m_email;
+    int m_birth_year;
+    int m_birth_month;
+    int m_birth_day;
+    string_view m_group;
+    double m_rating;
+    string_view m_phone_number;
+};
+
+// Tiny generator seeded per row, so a row depends only on the seed and its index,
+// never on the thread count
+struct SplitMix64 {
+    using result_type = uint64_t;
+    uint64_t state;
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+    uint64_t operator()() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
+
+struct GeneratorOptions {
+    size_t rows = 200000;
+    size_t groups = 200;
+    double groupSkew = 0.0;    // Zipf theta of the group sizes, 0 = equal sizes
+    string rating = "uniform:50:100";  // or normal:mean:stddev, clamped to [0, 100]
+    size_t emailLength = 0;    // pad emails to at least this many characters
+    uint64_t seed = 42;
+    unsigned threads = 0;      // 0 = all cores
+    string output = "students.csv";
+};
+
+// ABC-00, FIT-00, KPI-00, NXE-00, ABC-01, ...; 200 groups give the original ABC-00..NXE-49
+vector<string> makeGroupNames(size_t count) {
+    size_t perPrefix = (count + 3) / 4;
+    size_t width = max<size_t>(2, to_string(perPrefix - 1).size());
+    vector<string> names;
+    for (size_t g = 0; g < count; g++) {
+        string number = to_string(g / 4);
+        string name(kGroupPrefixes[g % 4]);
+        name += '-';
+        name.append(width - number.size(), '0');
+        name += number;
+        names.push_back(move(name));
+    }
+    return names;
+}
+
+class RowGenerator {
+private:
+    const GeneratorOptions& options;
+    const vector<string>& groupNames;
+    KeyChooser groupChooser;
+    bool normalRating = false;
+    double ratingA = 50.0;
+    double ratingB = 100.0;
+    string email;
+    char phone[14];
+
+public:
+    RowGenerator(const GeneratorOptions& generatorOptions, const vector<string>& names)
+        : options(generatorOptions), groupNames(names), groupChooser(names.size(), generatorOptions.groupSkew) {
+        char kind[16] = "uniform";
+        sscanf(options.rating.c_str(), "%15[a-z]:%lf:%lf", kind, &ratingA, &ratingB);
+        normalRating = string(kind) == "normal";
+    }
+
+    GeneratedStudent row(size_t index) {
+        SplitMix64 gen{options.seed * 0x2545f4914f6cdd1dULL + index};
+        GeneratedStudent s;
+        size_t name = gen() % size(kNames);
+        size_t surname = gen() % size(kSurnames);
+        s.m_name = kNames[name];
+        s.m_surname = kSurnames[surname];
+
+        // ivan.kravchenko17@student.org; the index keeps emails unique
+        email.assign(s.m_name);
+        email += '.';
+        email += s.m_surname;
+        for (char& c : email) {
+            c = tolower(c);
+        }
+        email += to_string(index);
+        const size_t kDomainLength = sizeof("@student.org") - 1;
+        while (email.size() + kDomainLength < options.emailLength) {
+            email += char('a' + gen() % 26);
+        }
+        email += "@student.org";
+        s.m_email = email;
+
+        s.m_birth_year = 1998 + gen() % 9;
+        s.m_birth_month = 1 + gen() % 12;
+        s.m_birth_day = 1 + gen() % 28;
+        s.m_group = groupNames[groupChooser(gen)];
+
+        double rating = normalRating ? normal_distribution<double>(ratingA, ratingB)(gen)
+                                     : uniform_real_distribution<double>(ratingA, ratingB)(gen);
+        s.m_rating = min(100.0, max(0.0, rating));
+
+        snprintf(phone, sizeof(phone), "+38050%07u", unsigned(gen() % 10000000));
+        s.m_phone_number = phone;
+        return s;
+    }
+};
+
+// Usage: ./generate_students [--rows 200000] [--groups 200] [--group-skew 0]
+//        [--rating uniform:50:100 | normal:75:10] [--email-length 0] [--seed 42]
+//        [--threads 0] [--output students.csv]
+// The output depends only on the options, not on the thread count.
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        string value = argv[i + 1];
+        if (arg == "--rows") {
+            options.rows = stoull(value);
+        } else if (arg == "--groups") {
+            options.groups = max<size_t>(1, stoull(value));
+        } else if (arg == "--group-skew") {
+            options.groupSkew = parseSkew(value);
+        } else if (arg == "--rating") {
+            options.rating = value;
+        } else if (arg == "--email-length") {
+            options.emailLength = stoull(value);
+        } else if (arg == "--seed") {
+            options.seed = stoull(value);
+        } else if (arg == "--threads") {
+            options.threads = stoul(value);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            cerr << "Unknown option " << arg << endl;
+        }
+    }
+
+    vector<string> groupNames = makeGroupNames(options.groups);
+    RowGenerator prototype(options, groupNames);
+
+    auto start = steady_clock::now();
+    bool ok = writeCSVParallel(options.output, options.rows, options.threads,
+                               [&](vector<char>& block, size_t begin, size_t end) {
+        RowGenerator generator = prototype;
+        size_t used = 0;
+        for (size_t i = begin; i < end; i++) {
+            GeneratedStudent s = generator.row(i);
+            size_t bound = studentRowBound(s);
+            if (used + bound > block.size()) {
+                block.resize(max(block.size() * 2, used + bound));
+            }
+            used = formatStudentRow(block.data() + used, s) - block.data();
+        }
+        return used;
+    });
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    if (!ok) {
+        cerr << "Error writing " << options.output << endl;
+        return 1;
+    }
+    cout << "Wrote " << options.rows << " students in " << options.groups << " groups to " << options.output
+         << " in " << fixed << setprecision(2) << seconds << " s (" << setprecision(0)
+         << options.rows / max(seconds, 1e-9) << " rows/sec)" << endl;
+    return 0;
+}